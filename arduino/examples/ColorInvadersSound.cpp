@@ -37,16 +37,31 @@
 /*********************************************************/
 #include <ENC.h>
 #include <PICxel.h>
+#include <lfsr_n.h>
 
 
-#define numberOfLEDs 30
+#ifndef numberOfLEDs
+#define numberOfLEDs 30   //can be overridden on the command line, the host benchmark builds several lengths
+#endif
+#if numberOfLEDs > 255
+#error "PICxel counts LEDs in a uint8_t, so one strip can't be longer than 255"
+#endif
 #define LED_pin 3
+#define seedPin A0            //analog pin left unconnected, its noise seeds the invader colors
 
 #define missileCharging 750  //charging time in milliseconds
 #define missileSpeed 25       //missile speed per pixel in milliseconds
+#define minInvaderDelay 100   //fastest the invaders are allowed to move in milliseconds
+
+#define debounceTime 5        //how long the button has to stay put before we believe it, in milliseconds
+#define buttonPollTime 1      //how often the button is sampled in milliseconds
+#define missileColorTime 10   //how often the charging/superShot missile is redrawn in milliseconds
+#define soundQueueSize 32     //number of notes that can be waiting to play
 
 //PICxel constructor(uint8_t # of LEDs, uint8_t pin #, color_mode GRB or HSV);
-PICxel strip(numberOfLEDs, LED_pin, HSV);
+//GRB mode so the library doesn't redo the HSV conversion for every LED on every refresh;
+//we convert once in setLED() instead, and the invaders use a table of their six colors
+PICxel strip(numberOfLEDs, LED_pin, GRB);
 uint8_t sat = 255;
 uint8_t value = 60;
 uint8_t chargingSat = 125;
@@ -54,6 +69,9 @@ uint8_t chargingVal = 20;
 
 ENC myENC;
 
+//same taps and seed as the enemy spawner in enemies.vhd, so the invader colors follow the FPGA's sequence
+LfsrN invaderRng(LFSR21_TAPS, LFSR21_ENEMY_SEED);
+
 // pin number of the pin that BTN is attach to 
 int btn = 30; 
 //determine which way the encoder was rotated
@@ -61,17 +79,16 @@ volatile int i;
 
 //game variables
 ////invaders variables
-uint16_t invaders[numberOfLEDs];           //invaders array holding the colors
-int invaderDelay = 3000;          //invaders move every 3000 ms (will be decreased as game progresses)
+uint32_t invaders[numberOfLEDs];           //invaders ring buffer holding the GRB colors, straight from invaderGRB
+uint16_t invaderHead = 0;         //ring buffer slot of the invader on LED 0; advancing it moves every invader down the buffer
+uint16_t invaderDelay = 3000;     //invaders move every 3000 ms (will be decreased as game progresses)
 int numberOfInvaders = 0;        //how many invaders are currently present
-int invaderDelayTime;            //global variable to hold how long it has been since the invader last moved
 
 ////missile variables
 uint16_t missileLocation = 0;     //start at the first spot
 boolean missileExists = false;    //boolean for the missile existence
 boolean missileInFlight = false;  //boolean for the in-flight missile
-int chargingTime;                 //global variable to hold the charging time
-int missileDelay;                 //global variable to hold how long it has been since the missile has last moved
+uint32_t chargingTime;            //global variable to hold when the missile started charging
 uint16_t missileColor;            //initialize the missile color that can be changed
 uint16_t missileInFlightColor;    //initialize the missile color in flight that will be constant
 
@@ -85,6 +102,79 @@ int buzzerPin = 28;
 int chargingFrequency = 0;      //frequency noise variable for charging up the missile
 int firingFrequency = 0;        //frequency noise variable for firing the missile
 boolean enableSound = false;      //by default, there is no sound for this game
+uint16_t noteFrequency[soundQueueSize];   //queued notes waiting to be played, 0 is a rest
+uint16_t noteDuration[soundQueueSize];    //how long each queued note lasts in milliseconds
+uint8_t noteHead = 0;                     //next note to play
+uint8_t noteCount = 0;                    //how many notes are waiting
+uint32_t soundEndTime = 0;                //when the last queued note will be done playing
+
+////LED strip variables
+uint32_t ledColors[numberOfLEDs];     //GRB value last written to each LED
+boolean stripDirty = false;           //true when an LED has changed since the last refresh
+uint32_t invaderGRB[6];               //GRB value of each invader color, filled in by setup()
+
+////button variables
+uint8_t buttonReading = LOW;      //last raw reading of the button
+uint8_t buttonState = LOW;        //debounced state of the button
+uint32_t buttonChangeTime = 0;    //when the raw reading last changed
+boolean firePending = false;      //pressed while the missile was charging; fires once it's charged if the button is still held
+
+////game state
+enum {playing, exploding, losing};
+uint8_t gameState = playing;      //the game only moves things along while playing
+
+////scheduler variables
+//every piece of the game is a small task that runs when its deadline comes up;
+//nothing ever waits in place, so the button is always being looked at
+typedef void (*taskFunction)(void);
+enum {buttonTask, missileColorTask, missileTask, invaderTask, soundTask, sequenceTask, numberOfTasks};
+taskFunction taskRun[numberOfTasks];  //what each task does
+uint32_t taskDue[numberOfTasks];      //millis() time each task should run next
+uint16_t taskPeriod[numberOfTasks];   //time between runs in milliseconds, 0 for a one-shot task
+boolean taskActive[numberOfTasks];    //whether each task is waiting to run
+
+
+/*********************************************************/
+/*                                                       */
+/*                  Function prototypes                  */
+/*                                                       */
+/*********************************************************/
+//this is a .cpp rather than a .ino, so nothing generates these for us
+void startTask(uint8_t task, taskFunction run, uint16_t delayMs, uint16_t periodMs);
+void stopTask(uint8_t task);
+void runTasks();
+void buttonStep();
+void buttonPressed();
+void fireIfReady();
+void missileColorStep();
+void missileStep();
+void invaderStep();
+void checkContact();
+void changeColor(int dir);
+uint16_t currentColor(int currentValue);
+uint8_t randomColor();
+boolean missileCharged();
+void updateMissileColor();
+void generateMissile();
+void fireMissile();
+void moveMissile();
+void missileContact();
+void explode();
+void explodeDone();
+void moveInvaders();
+void loseTheGame();
+void loseDone();
+void startGame();
+uint16_t invaderIndex(uint16_t led);
+uint32_t hsvToGRB(uint16_t hue, uint8_t s, uint8_t v);
+void setLED(uint16_t led, uint16_t hue, uint8_t s, uint8_t v);
+void setLEDGRB(uint16_t led, uint32_t grb);
+void clearLED(uint16_t led);
+void clearStrip();
+void showLEDs();
+void queueNote(double freqHz, uint16_t durationMs);
+void soundStep();
+uint16_t soundTimeLeft();
 
 
 /********************************************************/
@@ -121,27 +211,26 @@ void setup() {
   //initializing the WS2812 LED strip library code
   //start the code and clear the strip of any colors
   strip.begin();
-  strip.clear();
-  strip.refreshLEDs();
+  clearStrip();
+  showLEDs();
+  //work out the invader colors once, moving the invaders is then just copying these around
+  for(int color = 0; color < 6; color++){
+    invaderGRB[color] = hsvToGRB(currentColor(color), sat, value);
+  }
+  //start the invader colors somewhere different every power-up, from the noise on an unconnected pin
+  uint32_t seed = 0;
+  for(int bit = 0; bit < 21; bit++){
+    seed = (seed << 1) | (analogRead(seedPin) & 1);
+  }
+  if(seed == 0){seed = LFSR21_ENEMY_SEED;}   //an LFSR loaded with zero never leaves it
+  invaderRng.load(seed);
   //Some initial code to get things on the strip of LEDs
   //this will also help with the timing later on
   //Start out placing our missile
-  uint16_t missileColor;
-  if(missileExists == false){
-    missileColor = currentColor(i);
-    chargingTime = millis();
-    missileExists = true;
-    strip.HSVsetLEDColor(0, missileColor, chargingSat, chargingVal);
-  }
-  //then place our first invader
-  uint16_t invaderColor = randomColor();
-  invaders[numberOfLEDs-1] = invaderColor;
-  numberOfInvaders++;
-  strip.HSVsetLEDColor((numberOfLEDs-numberOfInvaders), invaderColor, sat, value);
-  invaderDelayTime = millis();
-  //update the whole display
-  strip.refreshLEDs();
-  updateMissileColor();
+  startGame();
+  //start the tasks that run for the whole game
+  startTask(buttonTask, buttonStep, buttonPollTime, buttonPollTime);
+  startTask(missileColorTask, missileColorStep, 0, missileColorTime);
 }//END of setup
 
 
@@ -151,11 +240,141 @@ void setup() {
 /*                                                      */
 /********************************************************/
 void loop() {  
+  //run whatever tasks are due; each one does a little bit of work and returns right away
+  runTasks();
+
+  //like i_lfsr_free_run in enemies.vhd, let the invader LFSR run while the game holds still,
+  //so how long the explosion and the lose glow take moves where the next invader colors come from
+  if(gameState != playing){
+    invaderRng.next();
+  }
+
+  //refresh the strip with new color values
+  showLEDs();
+}//END of loop
+
+/********************************************************/
+/*                                                      */
+/*                User Defined Functions                */
+/*                                                      */
+/********************************************************/
+
+
+/*************************************/
+/*                                   */
+/*        startTask function         */
+/*                                   */
+/*************************************/
+//schedule a task to run delayMs from now, then every periodMs after that (0 for just once)
+void startTask(uint8_t task, taskFunction run, uint16_t delayMs, uint16_t periodMs){
+  taskRun[task] = run;
+  taskDue[task] = millis() + delayMs;
+  taskPeriod[task] = periodMs;
+  taskActive[task] = true;
+}//END of startTask
+
+void stopTask(uint8_t task){
+  taskActive[task] = false;
+}//END of stopTask
+
+/*************************************/
+/*                                   */
+/*         runTasks function         */
+/*                                   */
+/*************************************/
+void runTasks(){
+  for(uint8_t task = 0; task < numberOfTasks; task++){
+    uint32_t now = millis();
+    //compare the signed difference so this keeps working when millis() rolls over
+    if(taskActive[task] == false || (int32_t)(now - taskDue[task]) < 0){
+      continue;
+    }
+    //pick the next deadline before running, so the task is free to restart or stop itself
+    if(taskPeriod[task] != 0){
+      taskDue[task] += taskPeriod[task];
+      //if we fell more than a period behind, don't try to catch up with a burst of runs
+      if((int32_t)(now - taskDue[task]) >= 0){
+        taskDue[task] = now + taskPeriod[task];
+      }
+    }
+    else{
+      taskActive[task] = false;
+    }
+    taskRun[task]();
+  }
+}//END of runTasks
+
+/*************************************/
+/*                                   */
+/*        buttonStep function        */
+/*                                   */
+/*************************************/
+//sample the button, only believing a change once it has held for debounceTime,
+//and act on the press edge rather than waiting for the button to be let go
+void buttonStep(){
+  uint8_t reading = digitalRead(btn);
+  uint32_t now = millis();
+  if(reading != buttonReading){
+    buttonReading = reading;
+    buttonChangeTime = now;
+  }
+  else if(reading != buttonState && (now - buttonChangeTime) >= debounceTime){
+    buttonState = reading;
+    if(buttonState == HIGH){
+      buttonPressed();
+    }
+    else{
+      firePending = false;   //let go before the missile was ready, so no shot
+    }
+  }
+  //a press that came in while the missile was charging fires as soon as the missile is ready
+  if(firePending == true){
+    fireIfReady();
+  }
+}//END of buttonStep
+
+/*************************************/
+/*                                   */
+/*      buttonPressed function       */
+/*                                   */
+/*************************************/
+void buttonPressed(){
+  //remember the press, buttonStep keeps trying while the button is held
+  firePending = true;
+  fireIfReady();
+}//END of buttonPressed
+
+/*************************************/
+/*                                   */
+/*       fireIfReady function        */
+/*                                   */
+/*************************************/
+void fireIfReady(){
+  //check to see if the missile is recharged, if so, fire!
+  if(gameState == playing && missileExists == true && missileInFlight == false && missileCharged()){
+    firePending = false;
+    fireMissile();
+    if(firingFrequency<10 && enableSound == true){
+      queueNote(800-(firingFrequency*20), 15);
+      firingFrequency++;
+    }
+  }
+}//END of fireIfReady
+
+/*************************************/
+/*                                   */
+/*     missileColorStep function     */
+/*                                   */
+/*************************************/
+void missileColorStep(){
+  if(gameState != playing){
+    return;
+  }
   //update the color of the missile; don't change it if the missile is in flight (unless it's a superShot)
   if(missileExists == true && (missileInFlight == false || superShot == true)){
     updateMissileColor();
   }//END of checking to see if we update the missile color
-  
+
   //allows user to prepare for the next invader color without changing the current missile color while in flight
   if(missileInFlight == true){
     missileColor = currentColor(i);
@@ -165,58 +384,56 @@ void loop() {
   if(missileExists == false){
     generateMissile();
   }//END of checking to see if we create the missile
-  
-  //check to see if the missile is recharged, if so, fire!
-  if(digitalRead(btn) && ((millis()-chargingTime)>missileCharging) && missileInFlight == false){
-    fireMissile();
-    strip.refreshLEDs();
-    delay(1);
-    if(firingFrequency<10 && enableSound == true){
-      playFreq(800-(firingFrequency*20), 15);
-      firingFrequency++;
-    }
-  }//END of checking to see if we fire the missile
-  
-  //check to see if it is time to move the missile along the strip
-  if(missileInFlight == true && ((millis()-missileDelay)>missileSpeed)){
-    moveMissile();
-    if(firingFrequency<10 && enableSound == true){
-      playFreq(800-(firingFrequency*20), 15);
-      firingFrequency++;
-    }
+}//END of missileColorStep
+
+/*************************************/
+/*                                   */
+/*       missileStep function        */
+/*                                   */
+/*************************************/
+void missileStep(){
+  if(gameState != playing || missileInFlight == false){
+    stopTask(missileTask);
+    return;
   }
-  
-  //check for contact on any LED value greater than 1
-  if(missileInFlight == true && missileLocation == (numberOfLEDs-numberOfInvaders)){
-    missileContact();
-  }//END of checking for missile contactIf
-  
-  //check to see if it is time to move the invaders
-  if((millis()-invaderDelayTime)>invaderDelay){
-    moveInvaders();
-  }//END of checking to see if it is time to move the invaders
-  
+  moveMissile();
+  if(firingFrequency<10 && enableSound == true){
+    queueNote(800-(firingFrequency*20), 15);
+    firingFrequency++;
+  }
+  checkContact();
+}//END of missileStep
+
+/*************************************/
+/*                                   */
+/*       invaderStep function        */
+/*                                   */
+/*************************************/
+void invaderStep(){
+  if(gameState != playing){
+    return;
+  }
+  moveInvaders();
+
   //check to see if the invaders have reached the first LED 0
   if((numberOfLEDs-numberOfInvaders)==0){
     loseTheGame();   //if invaders have won, lose the game; see user defined function for more details
+    return;
   }
-    
+  checkContact();
+}//END of invaderStep
+
+/*************************************/
+/*                                   */
+/*       checkContact function       */
+/*                                   */
+/*************************************/
+void checkContact(){
   //check for contact on any LED value greater than 1
   if(missileInFlight == true && missileLocation == (numberOfLEDs-numberOfInvaders)){
     missileContact();
   }//END of checking for missile contact
-  
-  //refresh the strip with new color values
-  strip.refreshLEDs();
-  delay(1);
-}//END of loop
-
-/********************************************************/
-/*                                                      */
-/*                User Defined Functions                */
-/*                                                      */
-/********************************************************/
-
+}//END of checkContact
 
 /*************************************/
 /*                                   */
@@ -250,23 +467,20 @@ uint16_t currentColor(int currentValue){
 /*       randomColor function        */
 /*                                   */
 /*************************************/
-//choose a color for the new color invader
-uint16_t randomColor(){
-  uint16_t hueColor;                  //the hue to return--saturation and value will remain at a set value
-  randomSeed(millis());               //generate our random spot in the 32-bit number stream
-  int colorCase = random(0,6);
-  switch(colorCase){                  //determine which of the 6 main color options we have choosen
-    case 0: hueColor = 0; break;      //red
-    case 1: hueColor = 1280; break;   //magenta/pink
-    case 2: hueColor = 555; break;    //green
-    case 3: hueColor = 111; break;    //orange
-    case 4: hueColor = 981; break;    //blue
-    case 5: hueColor = 751; break;    //cyan
-    default: break;
-  }   
-  return hueColor;
+//choose a color for the new color invader; returns the color number, look it up in invaderGRB or currentColor()
+uint8_t randomColor(){
+  return invaderRng.random(0,6);   //step the LFSR, then reduce it the same way the RTL does (mod)
 }//END of randomColor
 
+/*************************************/
+/*                                   */
+/*      missileCharged function      */
+/*                                   */
+/*************************************/
+boolean missileCharged(){
+  return superShot == true || (millis()-chargingTime) > missileCharging;
+}//END of missileCharged
+
 /*************************************/
 /*                                   */
 /*    updateMissileColor function    */
@@ -275,22 +489,24 @@ uint16_t randomColor(){
 void updateMissileColor(){
   missileColor = currentColor(i);
   //if the missile is done charging, do full saturation value
-  if((millis()-chargingTime)>missileCharging && superShot == false){
-    strip.HSVsetLEDColor(missileLocation, missileColor, sat, value);
+  if(missileCharged() && superShot == false){
+    setLED(missileLocation, missileColor, sat, value);
   }
   //if we are working with a super shot
   else if(superShot == true){
-    superShotHue +=15;
-    if(superShotHue >1535){superShotHue = 0;}
-    strip.HSVsetLEDColor(missileLocation, superShotHue, sat, value);
+    //the old loop() stepped the hue by 15 about every 2 ms, so scale it up to keep the rainbow the same speed
+    superShotHue += 15 * missileColorTime / 2;
+    if(superShotHue >1535){superShotHue -= 1536;}
+    setLED(missileLocation, superShotHue, sat, value);
   }
   //smaller saturation value if it is not done charging yet and not a superShot
   else{
-    if(chargingFrequency<100 && enableSound == true){
-      playFreq(300+(chargingFrequency*8), 10);
+    //only queue the next charging note once the last one is done so they don't pile up
+    if(chargingFrequency<100 && enableSound == true && noteCount == 0){
+      queueNote(300+(chargingFrequency*8), 10);
       chargingFrequency++;
     }
-    strip.HSVsetLEDColor(missileLocation, missileColor, chargingSat, chargingVal);
+    setLED(missileLocation, missileColor, chargingSat, chargingVal);
   }
 }//END of updateMissileColor
 
@@ -306,19 +522,18 @@ void generateMissile(){
     superShot = true;
     missileExists = true;
     superShotHue = currentColor(i);
-    strip.HSVsetLEDColor(missileLocation, superShotHue, sat, value);
-    chargingTime = 0;    //set an instantaneous charging time
+    setLED(missileLocation, superShotHue, sat, value);
     if(enableSound == true){
-      playFreq(659.255, 75);
-      playFreq(783.991, 75);
-      playFreq(1046.500, 75);
+      queueNote(659.255, 75);
+      queueNote(783.991, 75);
+      queueNote(1046.500, 75);
     }
   }
   //otherwise, it's just a normal shot
   else{
     missileColor = currentColor(i);
     missileLocation = 0;
-    strip.HSVsetLEDColor(missileLocation, missileColor, chargingSat, chargingVal);
+    setLED(missileLocation, missileColor, chargingSat, chargingVal);
     chargingTime = millis();
     missileExists = true;
     chargingFrequency = 0;
@@ -332,23 +547,21 @@ void generateMissile(){
 /*                                   */
 /*************************************/
 void fireMissile(){
-  while(digitalRead(btn)){}//wait while the button is being held down
-  delay(1);    //poor man's version of debouncing
   if(superShot == true){
     missileInFlight = true;
     missileLocation++;
-    strip.HSVsetLEDColor(missileLocation, superShotHue, sat, value);
-    strip.clear(missileLocation-1);
-    missileDelay = millis();
+    setLED(missileLocation, superShotHue, sat, value);
+    clearLED(missileLocation-1);
   }
   else{
     missileInFlightColor = currentColor(i);
     missileInFlight = true;
     missileLocation++;
-    strip.HSVsetLEDColor(missileLocation, missileInFlightColor, sat, value);
-    strip.clear(missileLocation-1);
-    missileDelay = millis();
+    setLED(missileLocation, missileInFlightColor, sat, value);
+    clearLED(missileLocation-1);
   }
+  startTask(missileTask, missileStep, missileSpeed, missileSpeed);
+  checkContact();
 }//END of fireMissile
 
 /*************************************/
@@ -359,15 +572,13 @@ void fireMissile(){
 void moveMissile(){
   if(superShot == true){
     missileLocation++;
-    strip.HSVsetLEDColor(missileLocation, superShotHue, sat, value);
-    strip.clear(missileLocation-1);
-    missileDelay = millis();
+    setLED(missileLocation, superShotHue, sat, value);
+    clearLED(missileLocation-1);
   }
   else{
     missileLocation++;
-    strip.HSVsetLEDColor(missileLocation, missileInFlightColor, sat, value);
-    strip.clear(missileLocation-1);
-    missileDelay = millis();
+    setLED(missileLocation, missileInFlightColor, sat, value);
+    clearLED(missileLocation-1);
   }
 }//END of moveMissile
 
@@ -378,7 +589,7 @@ void moveMissile(){
 /*************************************/
 void missileContact(){
   //if contact has occurred, check to see if the colors match
-  if(missileInFlightColor == invaders[numberOfLEDs-numberOfInvaders]){
+  if(hsvToGRB(missileInFlightColor, sat, value) == invaders[invaderIndex(numberOfLEDs-numberOfInvaders)]){
     explode();     //what it sounds like; see user defined function for more details
   }
   else if(superShot == true){
@@ -390,16 +601,14 @@ void missileContact(){
     missileExists = false;
     numberOfSuccessfulHits = 0;
     superShot = false;
-    strip.clear();
-    strip.refreshLEDs();
+    clearStrip();
   }
   else{
     //missile disspears, flags and counters reset, invaders continue
     missileInFlight = false;
     missileExists = false;
     numberOfSuccessfulHits = 0;
-    strip.HSVsetLEDColor((numberOfLEDs-numberOfInvaders), invaders[numberOfLEDs-numberOfInvaders], sat, value);
-    strip.refreshLEDs();
+    setLEDGRB((numberOfLEDs-numberOfInvaders), invaders[invaderIndex(numberOfLEDs-numberOfInvaders)]);
   }
 }//END of missileContact
 
@@ -412,41 +621,49 @@ void explode(){
   missileInFlight = false;
   missileExists = false;
   superShot = false;
-  invaderDelay = invaderDelay - 100;    //decrease how long the invaders wait to move
+  //decrease how long the invaders wait to move
+  if(invaderDelay >= minInvaderDelay + 100){invaderDelay = invaderDelay - 100;}
+  else{invaderDelay = minInvaderDelay;}
   numberOfSuccessfulHits++;
   numberOfInvaders--;          //decrease the total number of invaders
-  strip.HSVsetLEDColor(missileLocation, 981, 1, 125);    //blinding white light
-  strip.refreshLEDs();
+  setLED(missileLocation, 981, 1, 125);    //blinding white light
+  //hold everything still until the explosion is over; explodeDone picks the game back up
+  gameState = exploding;
+  stopTask(missileTask);
+  stopTask(invaderTask);
   if(enableSound == true){
-    playFreq(550, 40);
-    playFreq(404, 40);
-    playFreq(315, 40);
-    playFreq(494, 40);
-    playFreq(182, 40);
-    playFreq(260, 40);
-    playFreq(455, 40);
-    playFreq(387, 40);
-    playFreq(340, 40);
-    playFreq(550, 40);
-    playFreq(404, 40);
-    playFreq(315, 40);
-    playFreq(494, 40);
-    playFreq(182, 40);
-    playFreq(260, 40);
-    playFreq(455, 40);
-    playFreq(387, 40);
-    playFreq(340, 40);
-    delay(250);
+    queueNote(550, 40);
+    queueNote(404, 40);
+    queueNote(315, 40);
+    queueNote(494, 40);
+    queueNote(182, 40);
+    queueNote(260, 40);
+    queueNote(455, 40);
+    queueNote(387, 40);
+    queueNote(340, 40);
+    queueNote(550, 40);
+    queueNote(404, 40);
+    queueNote(315, 40);
+    queueNote(494, 40);
+    queueNote(182, 40);
+    queueNote(260, 40);
+    queueNote(455, 40);
+    queueNote(387, 40);
+    queueNote(340, 40);
+    startTask(sequenceTask, explodeDone, soundTimeLeft() + 250, 0);
   }
   else{
-    delay(1000);
+    startTask(sequenceTask, explodeDone, 1000, 0);
   }
-  invaderDelayTime = millis();        //reset how long it is until the invaders move again
-  strip.clear((numberOfLEDs-numberOfInvaders-1));
-  strip.refreshLEDs();
-  delay(1);
 }//END of explode
 
+void explodeDone(){
+  clearLED((numberOfLEDs-numberOfInvaders-1));
+  gameState = playing;
+  //reset how long it is until the invaders move again
+  startTask(invaderTask, invaderStep, invaderDelay, invaderDelay);
+}//END of explodeDone
+
 /*************************************/
 /*                                   */
 /*      moveInvaders function        */
@@ -454,17 +671,20 @@ void explode(){
 /*************************************/
 void moveInvaders(){
   numberOfInvaders++;          //increase the total number of invaders
-  //for every invader up until the last invader on the strip (that has to be created anyway),
-  //set the lower spot on the strip to the next higher spot on the strip
-  for(int invaderLocation = (numberOfLEDs-numberOfInvaders); invaderLocation<(numberOfLEDs-1); invaderLocation++){
-    invaders[invaderLocation] = invaders[invaderLocation+1];
-    strip.HSVsetLEDColor(invaderLocation, invaders[invaderLocation], sat, value);
-  }
+  //advance the ring buffer instead of shifting the array; every invader now sits one spot lower,
+  //but the strip itself has no ring buffer, so the loop below still rewrites every invader's LED
+  invaderHead++;
+  if(invaderHead >= numberOfLEDs){invaderHead = 0;}
   //create a new invader for the last spot on the strip
-  uint16_t invaderColor = randomColor();
-  invaders[numberOfLEDs-1] = invaderColor;
-  strip.HSVsetLEDColor((numberOfLEDs-1), invaders[numberOfLEDs-1], sat, value);
-  invaderDelayTime = millis();
+  invaders[invaderIndex(numberOfLEDs-1)] = invaderGRB[randomColor()];
+  //the ring buffer holds GRB, so each LED is only a copy; nearly every spot changes when the invaders
+  //move, so don't bother comparing like setLEDGRB does
+  for(int invaderLocation = (numberOfLEDs-numberOfInvaders); invaderLocation<numberOfLEDs; invaderLocation++){
+    uint32_t grb = invaders[invaderIndex(invaderLocation)];
+    ledColors[invaderLocation] = grb;
+    strip.GRBsetLEDColor(invaderLocation, (grb >> 16) & 0xFF, (grb >> 8) & 0xFF, grb & 0xFF);
+  }
+  stripDirty = true;
 }//END of moveInvaders
 
 /*************************************/
@@ -483,76 +703,216 @@ void loseTheGame(){
   invaderDelay = 5000;
   chargingFrequency = 0;
   firingFrequency = 0;
-  strip.clear();
-  
+  clearStrip();
+  //hold everything still while we mourn; loseDone starts the next game
+  gameState = losing;
+  stopTask(missileTask);
+  stopTask(invaderTask);
+
   //show the red glow
   for(int lose = 0; lose<10; lose++){
-    strip.HSVsetLEDColor(lose, 0, sat, (value - lose*5));
+    setLED(lose, 0, sat, (value - lose*5));
   }
-  strip.refreshLEDs();
   if(enableSound == true){
-    delay(400);
+    queueNote(0, 400);
     //wah wah wah wahwahwahwahwahwah
     for(double wah=0; wah<4; wah+=6.541){
-      playFreq(440+wah, 50);
+      queueNote(440+wah, 50);
     }
-    playFreq(466.164, 100);
-    delay(80);
+    queueNote(466.164, 100);
+    queueNote(0, 80);
     for(double wah=0; wah<5; wah+=4.939){
-      playFreq(415.305+wah, 50);
+      queueNote(415.305+wah, 50);
     }
-    playFreq(440.000, 100);
-    delay(80);
+    queueNote(440.000, 100);
+    queueNote(0, 80);
     for(double wah=0; wah<5; wah+=4.662){
-      playFreq(391.995+wah, 50);
+      queueNote(391.995+wah, 50);
     }
-    playFreq(415.305, 100);
-    delay(80);
+    queueNote(415.305, 100);
+    queueNote(0, 80);
     for(int j=0; j<7; j++){
-      playFreq(391.995, 70);
-      playFreq(415.305, 70);
+      queueNote(391.995, 70);
+      queueNote(415.305, 70);
     }
-    delay(400);
+    startTask(sequenceTask, loseDone, soundTimeLeft() + 400, 0);
   }
   else{
-    delay(1000);
+    startTask(sequenceTask, loseDone, 1000, 0);
   }
-  strip.clear();
-  strip.refreshLEDs();
-  
-  
+}//END of loseTheGame
+
+void loseDone(){
+  clearStrip();
   //reset the game like we do in the setup() function
+  startGame();
+}//END of loseDone
+
+/*************************************/
+/*                                   */
+/*        startGame function         */
+/*                                   */
+/*************************************/
+void startGame(){
   //start up the missile
   uint16_t missileColor;
   if(missileExists == false){
     missileColor = currentColor(i);
     chargingTime = millis();
     missileExists = true;
-    strip.HSVsetLEDColor(0, missileColor, chargingSat, chargingVal);
+    setLED(0, missileColor, chargingSat, chargingVal);
   }
-  //then re-place our first invader
-  uint16_t invaderColor = randomColor();
-  invaders[numberOfLEDs-1] = invaderColor;
+  //then place our first invader
+  uint32_t invaderColor = invaderGRB[randomColor()];
+  invaders[invaderIndex(numberOfLEDs-1)] = invaderColor;
   numberOfInvaders++;
-  strip.HSVsetLEDColor((numberOfLEDs-numberOfInvaders), invaderColor, sat, value);
-  invaderDelayTime = millis();
-  //update the whole display
-  strip.refreshLEDs();
-}//END of loseTheGame
+  setLEDGRB((numberOfLEDs-numberOfInvaders), invaderColor);
+  gameState = playing;
+  startTask(invaderTask, invaderStep, invaderDelay, invaderDelay);
+}//END of startGame
 
-void playFreq(double freqHz, int durationMs){
-  //Calculate the period in microseconds
-  int periodMicro = int((1/freqHz)*1000000);
-  int halfPeriod = periodMicro/2;
-   
-  //store start time
-  int startTime = millis();
-   
-  //(millis() - startTime) is elapsed play time
-  while((millis() - startTime) < durationMs){
-    digitalWrite(buzzerPin, HIGH);
-    delayMicroseconds(halfPeriod);
-    digitalWrite(buzzerPin, LOW);
-    delayMicroseconds(halfPeriod);
-  }
-}
+/*************************************/
+/*                                   */
+/*       invaderIndex function       */
+/*                                   */
+/*************************************/
+//ring buffer slot of the invader currently shown on the given LED
+uint16_t invaderIndex(uint16_t led){
+  uint16_t index = invaderHead + led;
+  if(index >= numberOfLEDs){index -= numberOfLEDs;}   //cheaper than % on the small micros
+  return index;
+}//END of invaderIndex
+
+/*************************************/
+/*                                   */
+/*         hsvToGRB function         */
+/*                                   */
+/*************************************/
+//convert a PICxel style HSV color (hue 0-1535) to a packed GRB value
+uint32_t hsvToGRB(uint16_t hue, uint8_t s, uint8_t v){
+  uint8_t sector = (hue >> 8) % 6;      //which of the 6 color wheel sections we are in
+  uint8_t frac = hue & 0xFF;            //how far into the section
+  uint8_t p = ((uint16_t)v * (255 - s)) >> 8;
+  uint8_t q = ((uint16_t)v * (255 - (((uint16_t)s * frac) >> 8))) >> 8;
+  uint8_t t = ((uint16_t)v * (255 - (((uint16_t)s * (255 - frac)) >> 8))) >> 8;
+  uint8_t r, g, b;
+  switch(sector){
+    case 0: r = v; g = t; b = p; break;
+    case 1: r = q; g = v; b = p; break;
+    case 2: r = p; g = v; b = t; break;
+    case 3: r = p; g = q; b = v; break;
+    case 4: r = t; g = p; b = v; break;
+    default: r = v; g = p; b = q; break;
+  }
+  return ((uint32_t)g << 16) | ((uint32_t)r << 8) | b;
+}//END of hsvToGRB
+
+/*************************************/
+/*                                   */
+/*          setLED function          */
+/*                                   */
+/*************************************/
+//set one LED, only marking the strip dirty if the color actually changed
+void setLED(uint16_t led, uint16_t hue, uint8_t s, uint8_t v){
+  setLEDGRB(led, hsvToGRB(hue, s, v));
+}//END of setLED
+
+void setLEDGRB(uint16_t led, uint32_t grb){
+  if(led >= numberOfLEDs){return;}      //the missile can run one spot past the end of the strip
+  if(ledColors[led] != grb){
+    ledColors[led] = grb;
+    strip.GRBsetLEDColor(led, (grb >> 16) & 0xFF, (grb >> 8) & 0xFF, grb & 0xFF);
+    stripDirty = true;
+  }
+}//END of setLEDGRB
+
+/*************************************/
+/*                                   */
+/*         clearLED function         */
+/*                                   */
+/*************************************/
+void clearLED(uint16_t led){
+  if(led >= numberOfLEDs){return;}
+  if(ledColors[led] != 0){
+    ledColors[led] = 0;
+    strip.clear(led);
+    stripDirty = true;
+  }
+}//END of clearLED
+
+/*************************************/
+/*                                   */
+/*        clearStrip function        */
+/*                                   */
+/*************************************/
+void clearStrip(){
+  strip.clear();
+  memset(ledColors, 0, sizeof(ledColors));
+  stripDirty = true;
+}//END of clearStrip
+
+/*************************************/
+/*                                   */
+/*         showLEDs function         */
+/*                                   */
+/*************************************/
+//push the colors out to the strip, but only if something changed since last time
+void showLEDs(){
+  if(stripDirty == true){
+    strip.refreshLEDs();
+    stripDirty = false;
+  }
+}//END of showLEDs
+
+/*************************************/
+/*                                   */
+/*        queueNote function         */
+/*                                   */
+/*************************************/
+//add a note (or a rest, with a frequency of 0) to the end of the sound queue;
+//soundStep plays them one after another in the background
+void queueNote(double freqHz, uint16_t durationMs){
+  if(noteCount >= soundQueueSize){
+    return;    //drop the note rather than wait for room
+  }
+  uint8_t slot = (noteHead + noteCount) % soundQueueSize;
+  noteFrequency[slot] = (uint16_t)(freqHz + 0.5);
+  noteDuration[slot] = durationMs;
+  noteCount++;
+
+  uint32_t now = millis();
+  if((int32_t)(soundEndTime - now) < 0){soundEndTime = now;}
+  soundEndTime += durationMs;
+
+  //wake the sound task up if it had nothing left to play
+  if(taskActive[soundTask] == false){
+    startTask(soundTask, soundStep, 0, 0);
+  }
+}//END of queueNote
+
+/*************************************/
+/*                                   */
+/*        soundStep function         */
+/*                                   */
+/*************************************/
+void soundStep(){
+  if(noteCount == 0){
+    noTone(buzzerPin);
+    return;
+  }
+  uint16_t freq = noteFrequency[noteHead];
+  uint16_t duration = noteDuration[noteHead];
+  noteHead = (noteHead + 1) % soundQueueSize;
+  noteCount--;
+  if(freq != 0){tone(buzzerPin, freq);}
+  else{noTone(buzzerPin);}
+  //come back when this note is over to start the next one (or go quiet)
+  startTask(soundTask, soundStep, duration, 0);
+}//END of soundStep
+
+//how many milliseconds of queued sound are left to play
+uint16_t soundTimeLeft(){
+  int32_t left = (int32_t)(soundEndTime - millis());
+  if(left < 0){return 0;}
+  return left;
+}//END of soundTimeLeft
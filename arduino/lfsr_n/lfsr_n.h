@@ -0,0 +1,72 @@
+// lfsr_n: Generic Linear Feedback Shift Register, bit for bit the same as bonuses/proj1/lfsr_n.vhd
+// Lets a sketch prototype spawns and effects with the exact sequence the FPGA will produce.
+// Copy this folder into your Arduino libraries folder (or make a new tab) and #include <lfsr_n.h>
+
+#ifndef LFSR_N_H
+#define LFSR_N_H
+
+#include <stdint.h>
+
+/*************************************************
+ * Public Constants
+ *************************************************/
+
+// Taps and seeds used by the RTL. Taps are the g_taps generic read as a binary number.
+#define LFSR8_TAPS         0xB8UL       // lfsr_n default, "10111000"
+#define LFSR8_SEED         0xFFUL       // lfsr_n default, X"FF"
+#define LFSR21_TAPS        0x140000UL   // enemies.vhd and starfield.vhd, "101000000000000000000"
+#define LFSR21_ENEMY_SEED  0x9A9A9UL    // enemies.vhd
+#define LFSR21_STAR_SEED   0x1FFFFFUL   // starfield.vhd default
+
+class LfsrN {
+public:
+  // taps: maximal length taps, the MSB set sets the register width (up to 32 bits)
+  // seed: must be non-zero
+  LfsrN(uint32_t taps = LFSR8_TAPS, uint32_t seed = LFSR8_SEED)
+    : taps_(taps), seed_(seed), sreg_(seed) {}
+
+  // Same as one clock with i_cnt_en = '1'. Returns the new register value.
+  uint32_t next() {
+    // Galois form, shifting right; the bit shifted out decides whether the taps are applied
+    sreg_ = (sreg_ >> 1) ^ (-(sreg_ & 1UL) & taps_);
+    return sreg_;
+  }
+
+  // Step n times, for skipping ahead to match a free running register
+  void advance(uint32_t n) {
+    while (n--) {
+      next();
+    }
+  }
+
+  // Same as i_reset = '1'
+  void reset() { sreg_ = seed_; }
+
+  // Same as i_load = '1'
+  void load(uint32_t data) { sreg_ = data; }
+
+  // Same as o_value
+  uint32_t value() const { return sreg_; }
+
+  // Same range reduction as the RTL: to_integer(unsigned(o_value)) mod range
+  // Note this is only as uniform as the RTL, keep range well below the register size.
+  // A range of 0 returns 0 rather than dividing by zero.
+  uint32_t mod(uint32_t range) const { return range ? sreg_ % range : 0; }
+
+  // Step, then pick a number from min to max-1 (a drop-in for Arduino's random(min, max))
+  // Like Arduino's, max <= min returns min, without stepping.
+  int32_t random(int32_t min, int32_t max) {
+    if (max <= min) {
+      return min;
+    }
+    next();
+    return min + (int32_t)mod((uint32_t)(max - min));
+  }
+
+private:
+  uint32_t taps_;
+  uint32_t seed_;
+  uint32_t sreg_;
+};
+
+#endif // LFSR_N_H
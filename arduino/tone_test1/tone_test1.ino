@@ -1,8 +1,12 @@
 // tone_test1: A sound effect sandbox for the "Arduino Apollo" with onboard Piezo on pin D9.
 
 #include "pitches.h"  // must include open source pitches.h found online in libraries folder or make a new tab => https://www.arduino.cc/en/Tutorial/toneMelody
+#include <lfsr_n.h>  // arduino/lfsr_n, same generator as lfsr_n.vhd so the FPGA can play the exact same sequence
 #define BUZZ_PIN 9
 
+// 21 bit register with the taps enemies.vhd uses
+LfsrN rng(LFSR21_TAPS, 500);
+
 void setup() {
 
   Serial.begin(9600);
@@ -50,15 +54,29 @@ void setup() {
 
   // delay(2000);
 
+  // how much faster is the LFSR than random()?
+  Serial.println("-----random() vs LfsrN, usec per 1000 calls------");
+  volatile long sink;
+  unsigned long start = micros();
+  for(int k = 0; k < 1000; k++){
+    sink = random(100,500);
+  }
+  Serial.println(micros() - start);
+  start = micros();
+  for(int k = 0; k < 1000; k++){
+    sink = rng.random(100,500);
+  }
+  Serial.println(micros() - start);
+  rng.reset();
+
   // randomly generated explosion sound
-  randomSeed(500);
   Serial.println("-----random explosion------");
   int numSteps = 20;
   int totalDurationMsec = 500;
   int waitTime = totalDurationMsec / numSteps;
 
   for(int k = 0; k < numSteps; k++){
-    int blow1 = random(100,500);
+    int blow1 = rng.random(100,500);
     // blow2 = random(5,10);
     tone(BUZZ_PIN, blow1, waitTime);
     delay(waitTime);
@@ -0,0 +1,133 @@
+-- Testbench for lfsr_n
+-- Steps the default 8 bit generics and the 21 bit ones from enemies.vhd and starfield.vhd,
+-- and checks the first 16 states after the seed. tools/lfsr_check/lfsr_check.cpp holds the
+-- same table and checks arduino/lfsr_n against it.
+-- Run with lfsr_n_tb.do in ModelSim (vsim -do lfsr_n_tb.do from this folder).
+LIBRARY ieee;
+USE ieee.std_logic_1164.all;
+use ieee.NUMERIC_STD.all;
+
+ENTITY lfsr_n_tb IS
+END lfsr_n_tb;
+
+ARCHITECTURE behavior OF lfsr_n_tb IS
+
+    -- Types
+    type t_vec8 is array (1 to 16) of std_logic_vector(7 downto 0);
+    type t_vec21 is array (1 to 16) of std_logic_vector(20 downto 0);
+
+    -- Functions
+    function to_slv21(value : integer) return std_logic_vector is
+    begin
+        return std_logic_vector(to_unsigned(value, 21));
+    end function;
+
+    -- Constants
+    CONSTANT clock_period: TIME := 20 ns; -- 50 MHz
+    constant c_taps21 : std_logic_vector(20 downto 0) := "101000000000000000000";
+    constant c_enemy_seed : std_logic_vector(20 downto 0) := to_slv21(16#9A9A9#);
+    constant c_star_seed : std_logic_vector(20 downto 0) := to_slv21(16#1FFFFF#);
+
+    constant c_vec_default : t_vec8 := (
+        X"C7", X"DB", X"D5", X"D2", X"69", X"8C", X"46", X"23",
+        X"A9", X"EC", X"76", X"3B", X"A5", X"EA", X"75", X"82"
+    );
+    constant c_vec_enemy : t_vec21 := (
+        to_slv21(16#10D4D4#), to_slv21(16#086A6A#), to_slv21(16#043535#), to_slv21(16#161A9A#),
+        to_slv21(16#0B0D4D#), to_slv21(16#1186A6#), to_slv21(16#08C353#), to_slv21(16#1061A9#),
+        to_slv21(16#1C30D4#), to_slv21(16#0E186A#), to_slv21(16#070C35#), to_slv21(16#17861A#),
+        to_slv21(16#0BC30D#), to_slv21(16#11E186#), to_slv21(16#08F0C3#), to_slv21(16#107861#)
+    );
+    constant c_vec_star : t_vec21 := (
+        to_slv21(16#1BFFFF#), to_slv21(16#19FFFF#), to_slv21(16#18FFFF#), to_slv21(16#187FFF#),
+        to_slv21(16#183FFF#), to_slv21(16#181FFF#), to_slv21(16#180FFF#), to_slv21(16#1807FF#),
+        to_slv21(16#1803FF#), to_slv21(16#1801FF#), to_slv21(16#1800FF#), to_slv21(16#18007F#),
+        to_slv21(16#18003F#), to_slv21(16#18001F#), to_slv21(16#18000F#), to_slv21(16#180007#)
+    );
+
+    -- Signal declarations
+    SIGNAL test_clk    : STD_LOGIC;
+    signal cnt_en : std_logic := '0';
+    signal default_out : std_logic_vector(7 downto 0);
+    signal enemy_out : std_logic_vector(20 downto 0);
+    signal star_out : std_logic_vector(20 downto 0);
+
+BEGIN
+
+    -- Instantiation and port mapping
+    UUT_default : entity work.lfsr_n
+    port map (
+        i_clock => test_clk,
+        i_reset => '0',
+        i_load => '0',
+        i_cnt_en => cnt_en,
+        i_data => (others => '0'),
+        o_value => default_out
+    );
+
+    UUT_enemy : entity work.lfsr_n
+    generic map (
+        g_taps => c_taps21,
+        g_init_seed => c_enemy_seed
+    )
+    port map (
+        i_clock => test_clk,
+        i_reset => '0',
+        i_load => '0',
+        i_cnt_en => cnt_en,
+        i_data => (others => '0'),
+        o_value => enemy_out
+    );
+
+    UUT_star : entity work.lfsr_n
+    generic map (
+        g_taps => c_taps21,
+        g_init_seed => c_star_seed
+    )
+    port map (
+        i_clock => test_clk,
+        i_reset => '0',
+        i_load => '0',
+        i_cnt_en => cnt_en,
+        i_data => (others => '0'),
+        o_value => star_out
+    );
+
+    clock_process: PROCESS
+    BEGIN
+        test_clk <= '0';
+        WAIT FOR clock_period/2;
+        test_clk <= '1';
+        WAIT FOR clock_period/2;
+    END PROCESS;
+
+    vectors: PROCESS
+    BEGIN
+        -- Hold for a clock, everything should still be at its seed
+        WAIT UNTIL rising_edge(test_clk);
+        WAIT FOR 1 ns;
+        assert default_out = X"FF" report "default: not at seed" severity error;
+        assert enemy_out = c_enemy_seed report "enemies: not at seed" severity error;
+        assert star_out = c_star_seed report "starfield: not at seed" severity error;
+
+        cnt_en <= '1';
+        for i in 1 to 16 loop
+            WAIT UNTIL rising_edge(test_clk);
+            WAIT FOR 1 ns;
+            assert default_out = c_vec_default(i)
+                report "default: state " & integer'image(i) & " is " & integer'image(to_integer(unsigned(default_out)))
+                severity error;
+            assert enemy_out = c_vec_enemy(i)
+                report "enemies: state " & integer'image(i) & " is " & integer'image(to_integer(unsigned(enemy_out)))
+                severity error;
+            assert star_out = c_vec_star(i)
+                report "starfield: state " & integer'image(i) & " is " & integer'image(to_integer(unsigned(star_out)))
+                severity error;
+        end loop;
+        cnt_en <= '0';
+
+        report "lfsr_n_tb: done" severity note;
+        WAIT;
+    END PROCESS;
+
+END;
@@ -0,0 +1,192 @@
+// lfsr_check: Checks arduino/lfsr_n against lfsr_n.vhd and times it against the usual PRNGs
+// For the 8 bit default and the 21 bit generics used by enemies.vhd and starfield.vhd:
+//   vectors  the first 16 states after the seed, against the table below and against a bit
+//            level model of the VHDL process (shift in '0', xor g_taps when sreg(0) = '1')
+//   period   steps until the seed comes back, which must be 2^N-1 for maximal length taps
+//   limits   random(a, a), random() with max < min, and mod(0) return without dividing by zero
+// Then times LfsrN::random() against rand() and std::mt19937 for a 0 to 5 pick, like randomColor().
+//
+// The vector table is the one bonuses/proj1/tb/lfsr_n_tb.vhd asserts, so one simulator run
+// of that testbench (bonuses/proj1/tb/lfsr_n_tb.do) ties these same numbers to the RTL.
+//
+// Build: g++ -O2 -std=c++17 -I../../arduino/lfsr_n lfsr_check.cpp -o lfsr_check
+// Usage: lfsr_check [-n draws]
+//   -n  draws per generator for the timing, default 10000000
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <random>
+#include <string>
+
+#include "lfsr_n.h"
+
+namespace {
+
+constexpr int c_num_vectors = 16;
+
+struct Generic {
+    const char* name;
+    const char* taps;  // g_taps as written in the VHDL
+    uint32_t seed;
+    uint32_t vectors[c_num_vectors];
+};
+
+const Generic c_generics[] = {
+    {"lfsr_n default", "10111000", LFSR8_SEED,
+     {0xC7, 0xDB, 0xD5, 0xD2, 0x69, 0x8C, 0x46, 0x23, 0xA9, 0xEC, 0x76, 0x3B, 0xA5, 0xEA, 0x75, 0x82}},
+    {"enemies.vhd", "101000000000000000000", LFSR21_ENEMY_SEED,
+     {0x10D4D4, 0x086A6A, 0x043535, 0x161A9A, 0x0B0D4D, 0x1186A6, 0x08C353, 0x1061A9,
+      0x1C30D4, 0x0E186A, 0x070C35, 0x17861A, 0x0BC30D, 0x11E186, 0x08F0C3, 0x107861}},
+    {"starfield.vhd", "101000000000000000000", LFSR21_STAR_SEED,
+     {0x1BFFFF, 0x19FFFF, 0x18FFFF, 0x187FFF, 0x183FFF, 0x181FFF, 0x180FFF, 0x1807FF,
+      0x1803FF, 0x1801FF, 0x1800FF, 0x18007F, 0x18003F, 0x18001F, 0x18000F, 0x180007}},
+};
+
+// The VHDL process, one character per bit, MSB first
+std::string vhdl_step(const std::string& sreg, const std::string& taps) {
+    std::string next = "0" + sreg.substr(0, sreg.size() - 1);
+    if (sreg.back() == '1') {
+        for (size_t b = 0; b < next.size(); b++) {
+            next[b] = (next[b] != taps[b]) ? '1' : '0';
+        }
+    }
+    return next;
+}
+
+std::string to_bits(uint32_t value, size_t width) {
+    std::string bits(width, '0');
+    for (size_t b = 0; b < width; b++) {
+        if (value & (1UL << (width - 1 - b))) {
+            bits[b] = '1';
+        }
+    }
+    return bits;
+}
+
+uint32_t from_bits(const std::string& bits) {
+    return std::strtoul(bits.c_str(), nullptr, 2);
+}
+
+bool check_vectors(const Generic& g) {
+    std::string taps = g.taps;
+    LfsrN lfsr(from_bits(taps), g.seed);
+    std::string sreg = to_bits(g.seed, taps.size());
+    bool ok = true;
+    for (int v = 0; v < c_num_vectors; v++) {
+        uint32_t got = lfsr.next();
+        sreg = vhdl_step(sreg, taps);
+        if (got != g.vectors[v] || from_bits(sreg) != g.vectors[v]) {
+            std::printf("  state %d: LfsrN %06X, VHDL model %06X, expected %06X\n", v + 1, got, from_bits(sreg),
+                        g.vectors[v]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool check_period(const Generic& g) {
+    std::string taps = g.taps;
+    uint32_t expected = (1UL << taps.size()) - 1;
+    LfsrN lfsr(from_bits(taps), g.seed);
+    uint32_t period = 0;
+    do {
+        if (lfsr.next() == 0) {
+            std::printf("  stuck at zero after %u steps\n", period + 1);
+            return false;
+        }
+        period++;
+    } while (lfsr.value() != g.seed && period <= expected);
+    if (period != expected) {
+        std::printf("  period %u, expected %u\n", period, expected);
+        return false;
+    }
+    return true;
+}
+
+// Arduino's random(min, max) gives back min when max <= min, and mod(0) must not divide by zero
+bool check_limits() {
+    LfsrN lfsr(LFSR21_TAPS, LFSR21_ENEMY_SEED);
+    bool ok = true;
+    if (lfsr.mod(0) != 0) {
+        std::printf("  mod(0) returned %u\n", lfsr.mod(0));
+        ok = false;
+    }
+    const int32_t c_limits[][2] = {{0, 0}, {5, 5}, {-3, -3}, {6, 0}, {2, -7}};
+    for (const auto& lim : c_limits) {
+        int32_t got = lfsr.random(lim[0], lim[1]);
+        if (got != lim[0]) {
+            std::printf("  random(%d, %d) returned %d, expected %d\n", lim[0], lim[1], got, lim[0]);
+            ok = false;
+        }
+    }
+    if (lfsr.value() != LFSR21_ENEMY_SEED) {
+        std::printf("  an empty range stepped the register to %06X\n", lfsr.value());
+        ok = false;
+    }
+    return ok;
+}
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Draw>
+void time_draws(const char* name, int draws, Draw draw) {
+    uint32_t counts[6] = {};
+    auto start = Clock::now();
+    for (int d = 0; d < draws; d++) {
+        counts[draw()]++;
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / draws;
+    std::printf("%-40s %8.2f ", name, ns);
+    for (uint32_t c : counts) {
+        std::printf(" %6.4f", double(c) / draws);
+    }
+    std::printf("\n");
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-n draws]\n", prog);
+    std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int draws = 10000000;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:")) != -1) {
+        switch (opt) {
+            case 'n': draws = std::atoi(optarg); break;
+            default: usage(argv[0]);
+        }
+    }
+    if (draws <= 0) {
+        usage(argv[0]);
+    }
+
+    bool ok = true;
+    std::printf("-- Vectors and period\n");
+    for (const Generic& g : c_generics) {
+        bool vectors_ok = check_vectors(g);
+        bool period_ok = check_period(g);
+        std::printf("%-16s taps %s seed %06X: vectors %s, period %s\n", g.name, g.taps, g.seed,
+                    vectors_ok ? "ok" : "FAIL", period_ok ? "ok" : "FAIL");
+        ok &= vectors_ok && period_ok;
+    }
+    bool limits_ok = check_limits();
+    std::printf("%-16s random() with an empty range, mod(0): %s\n", "limits", limits_ok ? "ok" : "FAIL");
+    ok &= limits_ok;
+
+    std::printf("\n-- %d draws of 0 to 5\n", draws);
+    std::printf("%-40s %8s  share of each value\n", "generator", "ns/draw");
+    LfsrN lfsr(LFSR21_TAPS, LFSR21_ENEMY_SEED);
+    time_draws("LfsrN::random (21 bit, enemies)", draws, [&] { return lfsr.random(0, 6); });
+    std::srand(1);
+    time_draws("rand() % 6", draws, [] { return std::rand() % 6; });
+    std::mt19937 mt(1);
+    std::uniform_int_distribution<int> dist(0, 5);
+    time_draws("std::mt19937, uniform_int_distribution", draws, [&] { return dist(mt); });
+
+    return ok ? 0 : 1;
+}
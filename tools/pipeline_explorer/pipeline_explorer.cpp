@@ -0,0 +1,462 @@
+// pipeline_explorer: Design space explorer for the proj1 pixel pipeline
+// Sweeps object counts through rough timing/cost models of each stage and reports
+// the slack left in each one, to find out what breaks first before touching the RTL.
+//
+// Build: g++ -O2 -std=c++17 -pthread pipeline_explorer.cpp -o pipeline_explorer
+// Usage: pipeline_explorer [-e lo:hi] [-f lo:hi] [-n lo:hi[:step]] [-s lo:hi] [-j threads] [-o plot.dat]
+//   -e  c_max_num_enemies (enemies.vhd)
+//   -f  c_max_num_fire    (enemies.vhd)
+//   -n  c_spr_num_elems   (defender_common.vhd)
+//   -s  c_num_stages      (enemies.vhd)
+//   -j  worker threads, default is one per core
+//   -o  plot data for the full grid, default pipeline_sweep.dat
+//
+// Stages modelled:
+//   pixel     Per-pixel compositing in image_gen.vhd, from i_scan_pos to the RGB outputs (ns)
+//   arb_logic Port scan in spr_rom_arb.vhd, state_getNextPort (ns)
+//   arb_bw    Sprite ROM bandwidth, worst case wait for a line fetch vs. the time before it is drawn (pixel clocks)
+//   update    The one cycle logical update in enemies.vhd at the frame pulse: collisions, spawn, stage (ns)
+//   update_seq The same update done one collision pair per clock in vertical blanking, as proposed in the README (pixel clocks).
+//             This is the alternative, not the current design, so it never counts as the failing stage.
+//   area      Logic elements against the 10M50 (LEs)
+//
+// The delay numbers are rough figures for a MAX 10 -6 part, every chain of priority muxes is
+// treated as linear, and the area model is calibrated to the Quartus report for the shipped
+// build (img/proj1_res_use.png). Use the results to compare configurations, not to sign off timing.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// VGA timing (defender_common.vhd)
+constexpr double c_pixel_clk_mhz = 25.175;
+constexpr int c_h_res = 640;
+constexpr int c_h_fp = 16;
+constexpr int c_h_sync = 96;
+constexpr int c_h_bp = 48;
+constexpr int c_v_res = 480;
+constexpr int c_v_fp = 10;
+constexpr int c_v_sync = 2;
+constexpr int c_v_bp = 33;
+constexpr int c_h_total = c_h_res + c_h_fp + c_h_sync + c_h_bp;   // 800
+constexpr int c_v_total = c_v_res + c_v_fp + c_v_sync + c_v_bp;   // 525
+constexpr int c_v_blank_clks = (c_v_total - c_v_res) * c_h_total; // Clocks between the frame pulse and the first visible line
+
+// Sprites (defender_common.vhd, sprite_draw.vhd)
+constexpr int c_spr_data_width_pix = 15;
+constexpr int c_spr_max_scale_x = 10;
+constexpr int c_spr_fixed_slots = 1 + 5 + 12; // Ship, hud lives, start screen text. Enemies take the slots after the hud.
+constexpr int c_spr_line_overhead = 3;        // ST_NEXT_LINE, ST_READ_MEM, ST_AWAIT_POS
+constexpr int c_arb_clks_per_grant = 4;       // state_getNextPort, state_updateRomAddr, state_waitForRomData, state_presentData
+
+// Widths of the values in the datapaths
+constexpr int c_coord_bits = 11;   // t_point_2d values
+constexpr int c_score_bits = 20;   // c_max_score
+constexpr int c_color_bits = 4;    // One channel, darken()
+constexpr int c_tracer_div_stages = 8;  // (x*64)/580 in enemies.vhd: 17 bit dividend, 10 bit divisor
+constexpr int c_spawn_y_mod_stages = 13; // lfsr mod c_spawn_range (447): 21 bit dividend, 9 bit divisor
+constexpr int c_spawn_var_mod_stages = 18; // lfsr mod c_num_enem_variants (12): 21 bit dividend, 4 bit divisor
+
+// Device (img/proj1_res_use.png)
+constexpr int c_device_les = 49760;
+constexpr int c_baseline_les = 14940;
+
+// Delay model, ns
+constexpr double t_level = 0.75;     // One LUT plus local routing
+constexpr double t_carry_bit = 0.05; // Per bit of a carry chain
+constexpr double t_reg = 1.5;        // Clock to out, setup and skew
+constexpr double c_period_ns = 1000.0 / c_pixel_clk_mhz;
+
+// Area model, LEs per unit
+constexpr int c_les_per_spr_elem = 260; // sprite_draw instance and its arbiter port
+constexpr int c_les_per_enemy = 170;    // State, movement, off screen and ship collision
+constexpr int c_les_per_fire = 430;     // State, movement, tracer divider, bullet
+constexpr int c_les_per_pair = 90;      // collide_rect and score mux for one enemy/fire pair
+constexpr int c_les_per_stage = 32;     // Score compare and table entry
+
+struct Config {
+    int enemies;
+    int fire;
+    int spr_elems;
+    int stages;
+};
+
+// The shipped build
+constexpr Config c_baseline = {6, 5, 24, 6};
+
+enum Stage { ST_PIXEL, ST_ARB_LOGIC, ST_ARB_BW, ST_UPDATE, ST_UPDATE_SEQ, ST_AREA, NUM_STAGES };
+const char* const c_stage_names[NUM_STAGES] = {"pixel", "arb_logic", "arb_bw", "update", "update_seq", "area"};
+const char* const c_stage_units[NUM_STAGES] = {"ns", "ns", "clk", "ns", "clk", "LE"};
+
+struct Result {
+    Config point; // As requested
+    Config cfg;   // After normalize()
+    double slack[NUM_STAGES];
+    double budget[NUM_STAGES];
+    int first_fail; // Stage with the least slack relative to its budget if any are negative, else -1
+};
+
+int clog2(int val) {
+    int bits = 0;
+    while ((1 << bits) < val) {
+        bits++;
+    }
+    return bits;
+}
+
+// Add or compare over a carry chain
+double carry(int bits) {
+    return t_level + bits * t_carry_bit;
+}
+
+// Restoring divider by a constant: one subtract and one mux per quotient bit
+double divider(int stages, int divisor_bits) {
+    return stages * (carry(divisor_bits) + t_level);
+}
+
+// Every sprite needs a slot, the enemies slots sit between the hud and the start screen text
+Config normalize(Config cfg) {
+    cfg.spr_elems = std::max(cfg.spr_elems, c_spr_fixed_slots + cfg.enemies);
+    return cfg;
+}
+
+double pixel_path_ns(const Config& cfg) {
+    // sprite_draw output: line mux by r_spr_pos_x, CLUT, transparency check, draw enable
+    double spr = 5 * t_level;
+    // Tracer: subtract from spawn x, scale by constant division, pick a bit of rand_slv, or with the tail compare
+    double tracer = carry(c_coord_bits) + divider(c_tracer_div_stages, 10) + 3 * t_level;
+    // Bullet: pos + size, then compare, x and y side by side
+    double bullet = 2 * carry(c_coord_bits) + t_level;
+
+    // enemies.vhd: later loop iterations win, so sprites, tracers and bullets form one long priority chain
+    double enemies = std::max({spr + (cfg.enemies + 2 * cfg.fire) * t_level,
+                               tracer + 2 * cfg.fire * t_level,
+                               bullet + cfg.fire * t_level});
+
+    // overlays.vhd: every slot left over after the enemies is chained behind the text
+    int overlay_sprs = cfg.spr_elems - 1 - 5 - cfg.enemies;
+    double overlays = spr + overlay_sprs * t_level + 2 * t_level;
+
+    // image_gen.vhd: ship, darken, overlays, then blanking
+    double out = std::max(enemies + t_level + carry(c_color_bits) + t_level, overlays + t_level) + t_level;
+    return out + t_reg;
+}
+
+double arb_logic_ns(const Config& cfg) {
+    // Two find-next-request loops over every port, then the address mux by port index
+    int scan = 2 * (clog2(cfg.spr_elems) + 1);
+    int addr_mux = (clog2(cfg.spr_elems) + 1) / 2;
+    return (1 + scan + addr_mux) * t_level + t_reg;
+}
+
+// Worst case every sprite wants its next line at once and is served last
+int arb_bw_slack_clks(const Config& cfg) {
+    int wait = cfg.spr_elems * c_arb_clks_per_grant + 1;
+    int window = c_h_total - c_spr_data_width_pix * c_spr_max_scale_x - c_spr_line_overhead;
+    return window - wait;
+}
+
+double update_path_ns(const Config& cfg) {
+    // Collisions: each pair depends on the alive flags left by the pairs before it, and score_inc is
+    // written by every pair in turn
+    double pair = 2 * carry(c_coord_bits);
+    double collide = pair + std::max(cfg.enemies + cfg.fire - 1, cfg.enemies * cfg.fire) * t_level;
+    // Movement and off screen check run alongside
+    double moved = carry(c_coord_bits) + 2 * carry(c_coord_bits);
+    double alive = std::max(collide, moved) + t_level;
+    // Count alive enemies and compare with the target for this stage
+    int count_bits = clog2(cfg.enemies + 1);
+    double num_alive = alive + count_bits * carry(count_bits);
+    double stage = carry(c_score_bits) + cfg.stages * t_level + t_level;
+    double spawn_ok = std::max(num_alive, stage) + carry(count_bits);
+
+    // Random spawn position and variant from the lfsr, then fit it inside the spawn range
+    double rand_y = divider(c_spawn_y_mod_stages, 9);
+    double rand_var = divider(c_spawn_var_mod_stages, 4) + t_level;
+    double spawn_pos = std::max(rand_y, rand_var) + 3 * carry(c_coord_bits);
+
+    // Write into the open slot
+    return std::max(spawn_ok, spawn_pos) + 2 * t_level + t_reg;
+}
+
+// The README's "collision processor": one pair per clock, one clock per object to move it,
+// one per stage to compare the score, and a few for the FSM to get going and finish up
+int update_seq_clks(const Config& cfg) {
+    return cfg.enemies * cfg.fire + cfg.enemies + cfg.fire + cfg.stages + 8;
+}
+
+int area_les_raw(const Config& cfg) {
+    return cfg.spr_elems * c_les_per_spr_elem + cfg.enemies * c_les_per_enemy + cfg.fire * c_les_per_fire +
+           cfg.enemies * cfg.fire * c_les_per_pair + cfg.stages * c_les_per_stage;
+}
+
+int area_les(const Config& cfg) {
+    // Everything the model doesn't cover (text, starfields, terrain, sound, accelerometer) is taken from the baseline
+    static const int fixed = c_baseline_les - area_les_raw(c_baseline);
+    return fixed + area_les_raw(cfg);
+}
+
+Result evaluate(const Config& in) {
+    Result res;
+    res.point = in;
+    res.cfg = normalize(in);
+    const Config& cfg = res.cfg;
+
+    res.budget[ST_PIXEL] = c_period_ns;
+    res.slack[ST_PIXEL] = c_period_ns - pixel_path_ns(cfg);
+    res.budget[ST_ARB_LOGIC] = c_period_ns;
+    res.slack[ST_ARB_LOGIC] = c_period_ns - arb_logic_ns(cfg);
+    res.budget[ST_ARB_BW] = c_h_total;
+    res.slack[ST_ARB_BW] = arb_bw_slack_clks(cfg);
+    res.budget[ST_UPDATE] = c_period_ns;
+    res.slack[ST_UPDATE] = c_period_ns - update_path_ns(cfg);
+    res.budget[ST_UPDATE_SEQ] = c_v_blank_clks;
+    res.slack[ST_UPDATE_SEQ] = c_v_blank_clks - update_seq_clks(cfg);
+    res.budget[ST_AREA] = c_device_les;
+    res.slack[ST_AREA] = c_device_les - area_les(cfg);
+
+    res.first_fail = -1;
+    double worst = 0.0;
+    for (int st = 0; st < NUM_STAGES; st++) {
+        if (st == ST_UPDATE_SEQ) {
+            continue;
+        }
+        double rel = res.slack[st] / res.budget[st];
+        if (rel < worst) {
+            worst = rel;
+            res.first_fail = st;
+        }
+    }
+    return res;
+}
+
+// Evaluate every point on a pool of worker threads
+std::vector<Result> run_sweep(const std::vector<Config>& points, unsigned threads) {
+    std::vector<Result> results(points.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < points.size(); i = next++) {
+            results[i] = evaluate(points[i]);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+    return results;
+}
+
+struct Range {
+    int lo;
+    int hi;
+    int step;
+};
+
+bool parse_range(const char* str, Range* range) {
+    Range r = {0, 0, 1};
+    int n = std::sscanf(str, "%d:%d:%d", &r.lo, &r.hi, &r.step);
+    if (n == 1) {
+        r.hi = r.lo;
+    }
+    if (n < 1 || r.step < 1 || r.lo < 1 || r.hi < r.lo) {
+        return false;
+    }
+    *range = r;
+    return true;
+}
+
+std::vector<int> range_values(const Range& r) {
+    std::vector<int> vals;
+    for (int v = r.lo; v <= r.hi; v += r.step) {
+        vals.push_back(v);
+    }
+    return vals;
+}
+
+void print_header() {
+    std::printf("%4s %4s %4s %4s %4s", "E", "F", "N", "S", "Nrun");
+    for (int st = 0; st < NUM_STAGES; st++) {
+        std::string col = std::string(c_stage_names[st]) + "(" + c_stage_units[st] + ")";
+        std::printf(" %14s", col.c_str());
+    }
+    std::printf("  %s\n", "first_fail");
+}
+
+// The point as requested, then the N it was evaluated with
+void print_row(const Result& res) {
+    std::printf("%4d %4d %4d %4d %4d", res.point.enemies, res.point.fire, res.point.spr_elems, res.point.stages,
+                res.cfg.spr_elems);
+    for (int st = 0; st < NUM_STAGES; st++) {
+        std::printf(" %14.2f", res.slack[st]);
+    }
+    std::printf("  %s\n", res.first_fail < 0 ? "-" : c_stage_names[res.first_fail]);
+}
+
+// Sweep one parameter from the baseline, holding the rest, and report where it first fails
+void axis_sweep(const char* name, int Config::*param, const Range& range, unsigned threads) {
+    std::vector<Config> points;
+    for (int v : range_values(range)) {
+        Config cfg = c_baseline;
+        cfg.*param = v;
+        points.push_back(cfg);
+    }
+    std::vector<Result> results = run_sweep(points, threads);
+
+    std::printf("\n-- Sweep %s, others at baseline\n", name);
+    print_header();
+    const Result* first = nullptr;
+    for (const Result& res : results) {
+        print_row(res);
+        if (!first && res.first_fail >= 0) {
+            first = &res;
+        }
+    }
+    if (first) {
+        std::printf("First failure: %s = %d, %s stage (%.2f %s)\n", name, first->point.*param,
+                    c_stage_names[first->first_fail], first->slack[first->first_fail],
+                    c_stage_units[first->first_fail]);
+    } else {
+        std::printf("No failures in range\n");
+    }
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-e lo:hi] [-f lo:hi] [-n lo:hi[:step]] [-s lo:hi] [-j threads] [-o plot.dat]\n",
+                 prog);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Range enemies = {1, 16, 1};
+    Range fire = {1, 12, 1};
+    Range spr_elems = {24, 64, 4};
+    Range stages = {1, 16, 1};
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string plot_file = "pipeline_sweep.dat";
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool ok = val != nullptr;
+        if (ok && std::strcmp(arg, "-e") == 0) {
+            ok = parse_range(val, &enemies);
+        } else if (ok && std::strcmp(arg, "-f") == 0) {
+            ok = parse_range(val, &fire);
+        } else if (ok && std::strcmp(arg, "-n") == 0) {
+            ok = parse_range(val, &spr_elems);
+        } else if (ok && std::strcmp(arg, "-s") == 0) {
+            ok = parse_range(val, &stages);
+        } else if (ok && std::strcmp(arg, "-j") == 0) {
+            ok = std::atoi(val) > 0;
+            threads = ok ? std::atoi(val) : threads;
+        } else if (ok && std::strcmp(arg, "-o") == 0) {
+            plot_file = val;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    std::printf("Pixel clock %.3f MHz (%.2f ns), %dx%d total, %d clocks of vertical blanking\n", c_pixel_clk_mhz,
+                c_period_ns, c_h_total, c_v_total, c_v_blank_clks);
+    std::printf("E = c_max_num_enemies, F = c_max_num_fire, N = c_spr_num_elems (raised to %d+E if needed), "
+                "S = c_num_stages\n",
+                c_spr_fixed_slots);
+    std::printf("Nrun = the N actually evaluated, when N was raised it differs from N\n");
+    std::printf("Columns are slack per stage, negative fails\n");
+
+    std::printf("\n-- Baseline\n");
+    print_header();
+    print_row(evaluate(c_baseline));
+
+    axis_sweep("c_max_num_enemies", &Config::enemies, enemies, threads);
+    axis_sweep("c_max_num_fire", &Config::fire, fire, threads);
+    axis_sweep("c_spr_num_elems", &Config::spr_elems, spr_elems, threads);
+    axis_sweep("c_num_stages", &Config::stages, stages, threads);
+
+    // Full grid
+    std::vector<Config> points;
+    for (int e : range_values(enemies)) {
+        for (int f : range_values(fire)) {
+            for (int n : range_values(spr_elems)) {
+                for (int s : range_values(stages)) {
+                    points.push_back({e, f, n, s});
+                }
+            }
+        }
+    }
+    std::vector<Result> results = run_sweep(points, threads);
+
+    FILE* plot = std::fopen(plot_file.c_str(), "w");
+    if (!plot) {
+        std::fprintf(stderr, "Can't open %s\n", plot_file.c_str());
+        return 1;
+    }
+    // Rows are the requested points; points where N was raised repeat the slack of the raised one,
+    // so filter on N == Nrun to plot each distinct configuration once
+    std::fprintf(plot, "# E F N S Nrun");
+    for (int st = 0; st < NUM_STAGES; st++) {
+        std::fprintf(plot, " %s_%s", c_stage_names[st], c_stage_units[st]);
+    }
+    std::fprintf(plot, " first_fail\n");
+
+    int num_fail[NUM_STAGES] = {};
+    int num_pass = 0;
+    const Result* first = nullptr;
+    int first_dist = 0;
+    for (const Result& res : results) {
+        std::fprintf(plot, "%d %d %d %d %d", res.point.enemies, res.point.fire, res.point.spr_elems, res.point.stages,
+                     res.cfg.spr_elems);
+        for (int st = 0; st < NUM_STAGES; st++) {
+            std::fprintf(plot, " %.3f", res.slack[st]);
+        }
+        std::fprintf(plot, " %s\n", res.first_fail < 0 ? "-" : c_stage_names[res.first_fail]);
+
+        if (res.first_fail < 0) {
+            num_pass++;
+            continue;
+        }
+        num_fail[res.first_fail]++;
+        // The failing point closest to the baseline, counting each added object
+        const Config& pt = res.point;
+        int dist = std::abs(pt.enemies - c_baseline.enemies) + std::abs(pt.fire - c_baseline.fire) +
+                   std::abs(pt.spr_elems - c_baseline.spr_elems) + std::abs(pt.stages - c_baseline.stages);
+        if (!first || dist < first_dist) {
+            first = &res;
+            first_dist = dist;
+        }
+    }
+    std::fclose(plot);
+
+    std::printf("\n-- Full grid, %zu points, %u worker thread(s), plot data in %s\n", results.size(), threads,
+                plot_file.c_str());
+    std::printf("Pass: %d\n", num_pass);
+    for (int st = 0; st < NUM_STAGES; st++) {
+        if (st != ST_UPDATE_SEQ) {
+            std::printf("Fail first in %-10s %d\n", c_stage_names[st], num_fail[st]);
+        }
+    }
+    if (first) {
+        std::printf("Closest failing configuration to baseline:\n");
+        print_header();
+        print_row(*first);
+    }
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+// ENC: Host stand-in for the PmodENC library. The encoder never turns.
+
+#ifndef ENC_H
+#define ENC_H
+
+#include "arduino_host.h"
+
+class ENC {
+public:
+    void begin(uint8_t, uint8_t) {}
+    void AttachInterrupt(void (*)(int)) {}
+};
+
+#endif // ENC_H
@@ -0,0 +1,99 @@
+// PICxel: Host stand-in for the chipKIT WS2812 library
+// Keeps the pixel buffer, counts refreshes, and charges the simulated clock for the time
+// the real library spends bit-banging the strip with interrupts off.
+// In HSV mode the real library converts every pixel on every refresh; so does this one.
+//
+// Signatures follow the sketch's note on the library: LED counts and indices are uint8_t, so one
+// strip is at most 255 LEDs. The HSV conversion below is a reference model of the PICxel hue
+// wheel (0-1535, six sections of 256), rounded exactly and written apart from the sketch's
+// hsvToGRB() so color_check can compare the two. It is not the library's own code; matching the
+// library bit for bit has not been checked against hardware.
+
+#ifndef PICXEL_H
+#define PICXEL_H
+
+#include <vector>
+
+#include "arduino_host.h"
+
+enum color_mode { GRB, HSV };
+
+// 24 bits at 1.25 us each, plus the latch
+inline uint32_t g_refresh_us_per_led = 30;
+inline uint32_t g_refresh_us_latch = 50;
+
+class PICxel {
+public:
+    PICxel(uint8_t num, uint8_t, color_mode mode) : mode_(mode), pixels_(num, 0), hsv_(num, 0), out_(num, 0) {}
+
+    void begin() {}
+    void clear() {
+        std::fill(pixels_.begin(), pixels_.end(), 0);
+        std::fill(hsv_.begin(), hsv_.end(), 0);
+    }
+    void clear(uint8_t led) {
+        if (led < pixels_.size()) {
+            pixels_[led] = 0;
+            hsv_[led] = 0;
+        }
+    }
+
+    void GRBsetLEDColor(uint8_t led, uint8_t g, uint8_t r, uint8_t b) {
+        if (led < pixels_.size()) {
+            pixels_[led] = ((uint32_t)g << 16) | ((uint32_t)r << 8) | b;
+        }
+        writes++;
+    }
+    void HSVsetLEDColor(uint8_t led, uint16_t hue, uint8_t sat, uint8_t val) {
+        if (led < hsv_.size()) {
+            hsv_[led] = ((uint32_t)hue << 16) | ((uint32_t)sat << 8) | val;
+        }
+        writes++;
+    }
+
+    void refreshLEDs() {
+        for (size_t i = 0; i < out_.size(); i++) {
+            out_[i] = (mode_ == HSV) ? convert(hsv_[i]) : pixels_[i];
+        }
+        refreshes++;
+        sim_advance_us(out_.size() * g_refresh_us_per_led + g_refresh_us_latch);
+    }
+
+    // What the strip is showing after the last refresh
+    uint32_t shown(uint8_t led) const { return out_[led]; }
+
+    uint32_t refreshes = 0;  // refreshLEDs() calls
+    uint64_t writes = 0;     // set*LEDColor() calls, 64 bit so the pixel stores can't alias it and slow the loop
+
+private:
+    // Exact HSV to GRB, rounded to the nearest step: section hue/256, f = (hue%256)/256, s and v
+    // out of 255. Integer so the HSV refresh in invader_bench costs about what the library's does.
+    static uint32_t convert(uint32_t hsv) {
+        uint32_t hue = (hsv >> 16) % 1536;
+        uint32_t s = (hsv >> 8) & 0xFF;
+        uint32_t v = hsv & 0xFF;
+        uint32_t f = hue % 256;
+        uint32_t p = scale(v, 255 * 256 - s * 256);
+        uint32_t q = scale(v, 255 * 256 - s * f);
+        uint32_t t = scale(v, 255 * 256 - s * (256 - f));
+        uint32_t r, g, b;
+        switch (hue / 256) {
+            case 0: r = v; g = t; b = p; break;
+            case 1: r = q; g = v; b = p; break;
+            case 2: r = p; g = v; b = t; break;
+            case 3: r = p; g = q; b = v; break;
+            case 4: r = t; g = p; b = v; break;
+            default: r = v; g = p; b = q; break;
+        }
+        return (g << 16) | (r << 8) | b;
+    }
+    // v * frac / (255 * 256), to the nearest
+    static uint32_t scale(uint32_t v, uint32_t frac) { return (v * frac + 255 * 128) / (255 * 256); }
+
+    color_mode mode_;
+    std::vector<uint32_t> pixels_;
+    std::vector<uint32_t> hsv_;
+    std::vector<uint32_t> out_;
+};
+
+#endif // PICXEL_H
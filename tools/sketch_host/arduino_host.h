@@ -0,0 +1,55 @@
+// arduino_host: Just enough of the Arduino/chipKIT core to build the sketches on a PC
+// Time is simulated. Nothing advances the clock except delay(), delayMicroseconds(),
+// PICxel::refreshLEDs() and the host program itself (sim_advance_us).
+
+#ifndef ARDUINO_HOST_H
+#define ARDUINO_HOST_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define PIN_LED2 13
+#define A0 14
+
+// Simulated time in microseconds. Kept wide so long runs don't wrap it; millis() and micros()
+// still wrap like the real ones.
+inline uint64_t g_sim_us = 0;
+
+// Pin reads go through here so the host program can play back button presses, bounce and all
+inline int (*g_digital_read)(uint8_t pin) = nullptr;
+
+inline void sim_advance_us(uint64_t us) { g_sim_us += us; }
+
+inline uint32_t millis() { return (uint32_t)(g_sim_us / 1000); }
+inline uint32_t micros() { return (uint32_t)g_sim_us; }
+inline void delay(uint32_t ms) { sim_advance_us(ms * 1000); }
+inline void delayMicroseconds(uint32_t us) { sim_advance_us(us); }
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) { return g_digital_read ? g_digital_read(pin) : LOW; }
+// A floating pin: 10 bits of noise, from rand() so a run can be repeated with srand()
+inline int analogRead(uint8_t) { return rand() & 0x3FF; }
+
+inline void tone(uint8_t, unsigned int) {}
+inline void noTone(uint8_t) {}
+
+inline void randomSeed(unsigned long seed) { srand(seed); }
+inline long random(long min, long max) { return min + rand() % (max - min); }
+
+struct HostSerial {
+    void begin(unsigned long) {}
+    void println(const char*) {}
+    void println(char) {}
+    void println(long) {}
+};
+inline HostSerial Serial;
+
+#endif // ARDUINO_HOST_H
@@ -0,0 +1,103 @@
+// color_check: ColorInvadersSound's hsvToGRB() against the PICxel stand-in's HSV mode
+// The sketch drives the strip in GRB mode and does its own HSV conversion, so its colors should
+// still be the ones an HSV mode strip would show. Checks, one LED at a time through refreshLEDs():
+//   every hue at the playing sat/value, and at the charging sat/val
+//   the explosion flash and every step of the lose glow, with the same arguments setLED() gets
+//   the six invader colors are all different, since missileContact() compares GRB values
+// Fails if any channel is off by more than c_tolerance.
+//
+// The reference is the stand-in's conversion, not the real library's; see PICxel.h.
+//
+// Build: g++ -O2 -std=c++17 -I. -I../../arduino/lfsr_n color_check.cpp -o color_check
+// Usage: color_check
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "arduino_host.h"
+#include "ENC.h"
+#include "PICxel.h"
+#include "lfsr_n.h"
+
+#include "../../arduino/examples/ColorInvadersSound.cpp"
+
+namespace {
+
+constexpr int c_tolerance = 1;  // The sketch shifts by 8 where the reference divides by 255
+
+struct Result {
+    int checked = 0;
+    int failed = 0;
+    int worst = 0;
+};
+
+int channel_diff(uint32_t a, uint32_t b) {
+    int worst = 0;
+    for (int shift = 0; shift <= 16; shift += 8) {
+        worst = std::max(worst, std::abs(int((a >> shift) & 0xFF) - int((b >> shift) & 0xFF)));
+    }
+    return worst;
+}
+
+void check(PICxel& ref, Result& res, uint16_t hue, uint8_t s, uint8_t v) {
+    ref.HSVsetLEDColor(0, hue, s, v);
+    ref.refreshLEDs();
+    uint32_t want = ref.shown(0);
+    uint32_t got = hsvToGRB(hue, s, v);
+    int diff = channel_diff(want, got);
+    res.checked++;
+    res.worst = std::max(res.worst, diff);
+    if (diff > c_tolerance) {
+        if (res.failed < 10) {
+            std::printf("  hue %4u sat %3u val %3u: sketch %06X, HSV strip %06X\n", hue, s, v, got, want);
+        }
+        res.failed++;
+    }
+}
+
+void report(const char* name, const Result& res, bool& ok) {
+    std::printf("%-32s %6d colors, worst channel off by %d: %s\n", name, res.checked, res.worst,
+                res.failed ? "FAIL" : "ok");
+    ok &= res.failed == 0;
+}
+
+}  // namespace
+
+int main() {
+    PICxel ref(1, LED_pin, HSV);
+    g_refresh_us_per_led = 0;
+    g_refresh_us_latch = 0;
+    bool ok = true;
+
+    Result playing;
+    Result charging;
+    for (uint16_t hue = 0; hue < 1536; hue++) {
+        check(ref, playing, hue, sat, value);
+        check(ref, charging, hue, chargingSat, chargingVal);
+    }
+    report("every hue, playing", playing, ok);
+    report("every hue, charging", charging, ok);
+
+    Result effects;
+    check(ref, effects, 981, 1, 125);  // explodeMissile()
+    for (int lose = 0; lose < numberOfLEDs; lose++) {
+        check(ref, effects, 0, sat, (value - lose * 5));  // loseGame(), wrapping the same way setLED() does
+    }
+    report("explosion and lose glow", effects, ok);
+
+    setup();
+    bool distinct = true;
+    for (int a = 0; a < 6; a++) {
+        for (int b = a + 1; b < 6; b++) {
+            if (invaderGRB[a] == invaderGRB[b]) {
+                std::printf("  invader colors %d and %d are both %06X\n", a, b, invaderGRB[a]);
+                distinct = false;
+            }
+        }
+    }
+    std::printf("%-32s %s\n", "invader colors all different", distinct ? "ok" : "FAIL");
+    ok &= distinct;
+
+    return ok ? 0 : 1;
+}
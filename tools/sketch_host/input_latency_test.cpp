@@ -0,0 +1,317 @@
+// input_latency_test: Worst case time from a button press to fireMissile() in ColorInvadersSound
+// Runs the sketch on a simulated clock and plays back bouncing button presses through the
+// debouncer and the task scheduler, with the strip refresh costing from nothing up to several
+// ms of blocked CPU. Fails if any press takes longer than the bound worked out below.
+//
+// Build: g++ -O2 -std=c++17 -I. -I../../arduino/lfsr_n input_latency_test.cpp -o input_latency_test
+// Usage: input_latency_test [-n presses] [-s seed]
+//   -n  presses per case, default 300
+//   -s  seed for the press timing and bounce, default 1
+//
+// Bound, from the first edge of the press:
+//   the contacts settle                     bounce
+//   the next poll sees the last edge        one pass (a poll, or a refresh plus a pass if longer)
+//   it has to hold for debounceTime         debounceTime + 1 ms, since millis() counts whole ms
+//   the poll that accepts it                one more pass
+// The press is acted on from inside buttonStep, so the fire happens in that same pass.
+//
+// Then presses while the missile is still charging:
+//   held past the charge   must fire no later than one pass after missileCharged() turns true
+//   let go before it       must not fire at all
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <random>
+#include <vector>
+
+#include "arduino_host.h"
+#include "ENC.h"
+#include "PICxel.h"
+#include "lfsr_n.h"
+
+#include "../../arduino/examples/ColorInvadersSound.cpp"
+
+namespace {
+
+constexpr uint32_t c_pass_us = 20;        // Rough cost of one loop() pass, besides the strip
+constexpr uint32_t c_bounce_max_us = 3000;  // Longest the contacts chatter on press or release
+constexpr uint32_t c_timeout_us = 200000;   // Give up on a press that hasn't fired by now
+
+struct Case {
+    const char* name;
+    uint32_t refresh_us_per_led;
+    bool redraw_every_pass;  // Something is animating, so every pass pays for a refresh
+};
+
+const Case c_cases[] = {
+    {"free refresh", 0, false},
+    {"30 LEDs, redraw on change", 30, false},
+    {"30 LEDs, redraw every pass", 30, true},
+    {"255 LED strip, redraw every pass", 255, true},  // 30 LEDs at 8.5x the cost, the game stays the same length
+};
+
+// Button edges as (time, level), played back through digitalRead()
+std::vector<std::pair<uint64_t, int>> g_edges;
+
+int button_read(uint8_t pin) {
+    if (pin != btn) {
+        return LOW;
+    }
+    int level = LOW;
+    for (const auto& edge : g_edges) {
+        if (edge.first > g_sim_us) {
+            break;
+        }
+        level = edge.second;
+    }
+    return level;
+}
+
+// Chatter for up to c_bounce_max_us from start, ending on level
+uint64_t add_bounce(std::mt19937& rng, uint64_t start, int level) {
+    uint32_t bounce = std::uniform_int_distribution<uint32_t>(0, c_bounce_max_us)(rng);
+    int flips = std::uniform_int_distribution<int>(0, 4)(rng) * 2;  // Even, so it settles where it started
+    std::vector<uint64_t> times;
+    for (int f = 0; f < flips; f++) {
+        times.push_back(start + std::uniform_int_distribution<uint32_t>(1, std::max(bounce, 1U))(rng));
+    }
+    std::sort(times.begin(), times.end());
+    g_edges.push_back({start, level});
+    for (int f = 0; f < flips; f++) {
+        g_edges.push_back({times[f], (f % 2 == 0) ? !level : level});
+    }
+    return start + bounce;
+}
+
+// One pass of loop(), with a look between the tasks and the refresh to catch the fire.
+// Only the refresh and the pass itself move the clock, so the time after runTasks() is the fire time.
+bool pass(const Case& c, uint64_t* fire_us = nullptr) {
+    bool was_in_flight = missileInFlight;
+    runTasks();
+    bool fired = !was_in_flight && missileInFlight;
+    if (fired && fire_us) {
+        *fire_us = g_sim_us;
+    }
+    if (c.redraw_every_pass) {
+        stripDirty = true;
+    }
+    showLEDs();
+    sim_advance_us(c_pass_us);
+    return fired;
+}
+
+// Also keep the front invader a few LEDs off, so the missile is still in flight after the pass that fires it
+bool ready_to_fire() {
+    return gameState == playing && missileExists && !missileInFlight && missileCharged() &&
+           buttonState == LOW && buttonReading == LOW && numberOfLEDs - numberOfInvaders >= 3;
+}
+
+// Strip cost for the case, and the longest one pass of loop() can take
+uint32_t set_refresh(const Case& c, uint32_t* pass_us) {
+    g_refresh_us_per_led = c.refresh_us_per_led;
+    g_refresh_us_latch = c.refresh_us_per_led ? 50 : 0;
+    uint32_t refresh_us = numberOfLEDs * g_refresh_us_per_led + g_refresh_us_latch;
+    *pass_us = std::max<uint32_t>(buttonPollTime * 1000, refresh_us + c_pass_us);
+    return refresh_us;
+}
+
+// Let go, and make sure the release is seen before the next press
+void release_button(const Case& c, std::mt19937& rng, uint64_t release) {
+    add_bounce(rng, std::max(release, g_sim_us), LOW);
+    while (g_sim_us < g_edges.back().first + (debounceTime + 2) * 1000 || buttonState != LOW) {
+        pass(c);
+    }
+}
+
+// First time missileCharged() is true for the missile charging now
+uint64_t charged_at_us() {
+    return (uint64_t(chargingTime) + missileCharging + 1) * 1000;
+}
+
+// Wait for a missile that has at least needed_us of charging left, firing the charged ones to get there
+void wait_for_charging(const Case& c, std::mt19937& rng, uint64_t needed_us) {
+    while (true) {
+        if (gameState == playing && missileExists && !missileInFlight && !missileCharged() && buttonState == LOW &&
+            buttonReading == LOW && numberOfLEDs - numberOfInvaders >= 3 && charged_at_us() >= g_sim_us + needed_us) {
+            return;
+        }
+        if (ready_to_fire()) {
+            g_edges.clear();
+            add_bounce(rng, g_sim_us, HIGH);
+            release_button(c, rng, g_sim_us + 20000);
+        }
+        else {
+            pass(c);
+        }
+    }
+}
+
+bool run_case(const Case& c, int presses, std::mt19937& rng) {
+    uint32_t pass_us;
+    uint32_t refresh_us = set_refresh(c, &pass_us);
+    uint32_t bound_us = c_bounce_max_us + pass_us + (debounceTime + 1) * 1000 + pass_us;
+
+    uint32_t worst = 0;
+    uint64_t total = 0;
+    int fired = 0;
+    int lost = 0;
+    for (int p = 0; p < presses; p++) {
+        // Wait for the missile, then press anywhere in the next pass
+        while (!ready_to_fire()) {
+            pass(c);
+        }
+        g_edges.clear();
+        uint64_t press = g_sim_us + std::uniform_int_distribution<uint32_t>(0, pass_us)(rng);
+        uint64_t settled = add_bounce(rng, press, HIGH);
+        uint64_t release = settled + std::uniform_int_distribution<uint32_t>(30000, 150000)(rng);
+
+        uint64_t fire_time = 0;
+        while (g_sim_us < press + c_timeout_us) {
+            if (pass(c, &fire_time)) {
+                break;
+            }
+            if (gameState != playing) {
+                break;
+            }
+        }
+        if (fire_time == 0 && gameState != playing) {
+            p--;  // The invaders got there first, try again next game
+        }
+        else if (fire_time == 0) {
+            lost++;
+        }
+        else {
+            uint32_t latency = (uint32_t)(fire_time - press);
+            worst = std::max(worst, latency);
+            total += latency;
+            fired++;
+        }
+
+        release_button(c, rng, release);
+    }
+
+    bool ok = lost == 0 && worst <= bound_us;
+    std::printf("%-34s %6.2f %6d %6.2f %6.2f %6.2f  %s\n", c.name, refresh_us / 1000.0, fired,
+                fired ? total / 1000.0 / fired : 0.0, worst / 1000.0, bound_us / 1000.0, ok ? "ok" : "FAIL");
+    if (lost) {
+        std::printf("  %d press(es) never fired\n", lost);
+    }
+    return ok;
+}
+
+// Presses that land while the missile is charging, half held past the charge and half let go before it
+bool run_charging_case(const Case& c, int presses, std::mt19937& rng) {
+    uint32_t pass_us;
+    uint32_t refresh_us = set_refresh(c, &pass_us);
+    uint32_t bound_us = pass_us;
+    // Room for the press to bounce, settle and be let go again before the charge is done
+    uint64_t needed_us = 2 * (c_bounce_max_us + (debounceTime + 2) * 1000 + pass_us);
+
+    uint32_t worst = 0;
+    uint64_t total = 0;
+    int fired = 0;
+    int lost = 0;
+    int early = 0;
+    int unwanted = 0;
+    for (int p = 0; p < presses; p++) {
+        bool hold = p % 2 == 0;
+        wait_for_charging(c, rng, needed_us);
+        uint64_t charged = charged_at_us();
+        g_edges.clear();
+        uint64_t latest = charged - needed_us / (hold ? 2 : 1);  // Seen pressed, or pressed and let go, before the charge is done
+        uint64_t press = std::uniform_int_distribution<uint64_t>(g_sim_us, latest)(rng);
+        uint64_t settled = add_bounce(rng, press, HIGH);
+        uint64_t release = hold ? charged + std::uniform_int_distribution<uint32_t>(30000, 150000)(rng)
+                                : settled + (debounceTime + 2) * 1000 + pass_us;
+        if (!hold) {
+            add_bounce(rng, release, LOW);
+        }
+
+        // Watch until well after the charge is done, or the release for a held press
+        uint64_t fire_time = 0;
+        uint64_t watch_until = hold ? std::min<uint64_t>(release, charged + c_timeout_us) : charged + 50000;
+        while (g_sim_us < watch_until) {
+            if (pass(c, &fire_time) || gameState != playing) {
+                break;
+            }
+        }
+        if (fire_time == 0 && gameState != playing) {
+            p--;  // The invaders got there first, try again next game
+        }
+        else if (!hold && fire_time != 0) {
+            unwanted++;
+        }
+        else if (hold && fire_time == 0) {
+            lost++;
+        }
+        else if (hold && fire_time < charged) {
+            early++;
+        }
+        else if (hold) {
+            uint32_t latency = (uint32_t)(fire_time - charged);
+            worst = std::max(worst, latency);
+            total += latency;
+            fired++;
+        }
+
+        release_button(c, rng, hold ? release : g_sim_us);
+    }
+
+    bool ok = lost == 0 && early == 0 && unwanted == 0 && worst <= bound_us;
+    std::printf("%-34s %6.2f %6d %6.2f %6.2f %6.2f  %s\n", c.name, refresh_us / 1000.0, fired,
+                fired ? total / 1000.0 / fired : 0.0, worst / 1000.0, bound_us / 1000.0, ok ? "ok" : "FAIL");
+    if (lost) {
+        std::printf("  %d held press(es) never fired\n", lost);
+    }
+    if (early) {
+        std::printf("  %d press(es) fired before the missile was charged\n", early);
+    }
+    if (unwanted) {
+        std::printf("  %d press(es) let go while charging still fired\n", unwanted);
+    }
+    return ok;
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-n presses] [-s seed]\n", prog);
+    std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int presses = 300;
+    unsigned seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+        switch (opt) {
+            case 'n': presses = std::atoi(optarg); break;
+            case 's': seed = std::atoi(optarg); break;
+            default: usage(argv[0]);
+        }
+    }
+    if (presses <= 0) {
+        usage(argv[0]);
+    }
+
+    std::mt19937 rng(seed);
+    g_digital_read = button_read;
+    setup();
+
+    std::printf("Press edge to fireMissile(), %d presses per case, up to %.1f ms of bounce\n", presses,
+                c_bounce_max_us / 1000.0);
+    std::printf("%-34s %6s %6s %6s %6s %6s\n", "case", "refr", "fired", "avg", "max", "bound");
+    bool ok = true;
+    for (const Case& c : c_cases) {
+        ok &= run_case(c, presses, rng);
+    }
+
+    std::printf("\nPressed while charging: charge done to fireMissile() if held, no fire if let go first\n");
+    std::printf("%-34s %6s %6s %6s %6s %6s\n", "case", "refr", "fired", "avg", "max", "bound");
+    for (const Case& c : c_cases) {
+        ok &= run_charging_case(c, presses, rng);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+// invader_bench: Invader move and strip refresh cost of ColorInvadersSound vs. strip length
+// Builds the sketch once per strip length against the host stand-ins for PICxel and ENC, and
+// compares it with the original code: moveInvaders() shifting the whole array and rewriting
+// every invader, on an HSV mode strip refreshed (then delay(1)) on every pass of loop().
+//
+// Build: g++ -O2 -std=c++17 -I. -I../../arduino/lfsr_n invader_bench.cpp -o invader_bench
+// Usage: invader_bench [-m moves] [-t seconds]
+//   -m  moves timed per strip length, default 200000
+//   -t  simulated seconds of play with nobody pressing anything, default 10
+//
+// Columns, old code then ring buffer:
+//   move_ns    host time for one moveInvaders() with the strip full of invaders; the old code
+//              leaves the HSV conversion to the library, so it shows up in its refr_ns instead
+//   writes     LEDs handed to the library per move
+//   refr_ns    host time for one refreshLEDs() (HSV mode converts every LED on every refresh)
+//   refreshes  refreshLEDs() calls over the simulated play time
+//   busy       simulated ms per second spent clocking out the strip, at 30 us per LED
+// Host times only compare the two versions; the PIC32 is a lot slower than the PC running this.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+
+#include "arduino_host.h"
+#include "ENC.h"
+#include "PICxel.h"
+#include "lfsr_n.h"
+
+// One copy of the sketch per strip length, each in its own namespace, up to the 255 LEDs PICxel can count
+namespace leds30 {
+#define numberOfLEDs 30
+#include "../../arduino/examples/ColorInvadersSound.cpp"
+#undef numberOfLEDs
+}
+namespace leds60 {
+#define numberOfLEDs 60
+#include "../../arduino/examples/ColorInvadersSound.cpp"
+#undef numberOfLEDs
+}
+namespace leds120 {
+#define numberOfLEDs 120
+#include "../../arduino/examples/ColorInvadersSound.cpp"
+#undef numberOfLEDs
+}
+namespace leds150 {
+#define numberOfLEDs 150
+#include "../../arduino/examples/ColorInvadersSound.cpp"
+#undef numberOfLEDs
+}
+namespace leds255 {
+#define numberOfLEDs 255
+#include "../../arduino/examples/ColorInvadersSound.cpp"
+#undef numberOfLEDs
+}
+
+namespace {
+
+constexpr uint32_t c_pass_us = 20;  // Rough cost of one loop() pass with nothing due, besides the strip
+
+// The parts of the original sketch that touch the strip, as they were before the ring buffer
+template <int N>
+struct OldGame {
+    PICxel strip{N, 3, HSV};
+    LfsrN rng{LFSR21_TAPS, LFSR21_ENEMY_SEED};
+    uint16_t invaders[N] = {};
+    int invaderDelay = 3000;
+    int numberOfInvaders = 0;
+    uint32_t invaderDelayTime = 0;
+    uint8_t sat = 255;
+    uint8_t value = 60;
+
+    uint16_t randomColor() {
+        static const uint16_t hues[6] = {0, 1280, 555, 111, 981, 751};
+        return hues[rng.random(0, 6)];
+    }
+
+    void moveInvaders() {
+        numberOfInvaders++;
+        for (int loc = N - numberOfInvaders; loc < N - 1; loc++) {
+            invaders[loc] = invaders[loc + 1];
+            strip.HSVsetLEDColor(loc, invaders[loc], sat, value);
+        }
+        invaders[N - 1] = randomColor();
+        strip.HSVsetLEDColor(N - 1, invaders[N - 1], sat, value);
+        invaderDelayTime = millis();
+    }
+
+    void loopPass() {
+        if ((millis() - invaderDelayTime) > (uint32_t)invaderDelay) {
+            moveInvaders();
+        }
+        strip.refreshLEDs();
+        delay(1);
+    }
+};
+
+// What the benchmark needs from one copy of the sketch
+struct Sketch {
+    int leds;
+    void (*setup)();
+    void (*loop)();
+    void (*moveInvaders)();
+    int* numberOfInvaders;
+    PICxel* strip;
+};
+
+#define SKETCH(n) Sketch{n, leds##n::setup, leds##n::loop, leds##n::moveInvaders, \
+                         &leds##n::numberOfInvaders, &leds##n::strip}
+
+struct Cost {
+    double move_ns;
+    double writes;
+    double refr_ns;
+    uint32_t refreshes;
+    double busy_ms;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+template <typename MoveFn>
+void time_moves(PICxel& strip, int* num_invaders, int leds, int moves, MoveFn move, Cost& cost) {
+    // Keep the strip full; the move redraws every invader from the front one back
+    *num_invaders = leds - 2;
+    uint64_t writes = strip.writes;
+    auto start = Clock::now();
+    for (int m = 0; m < moves; m++) {
+        move();
+        (*num_invaders)--;
+    }
+    cost.move_ns = elapsed_ns(start) / moves;
+    cost.writes = double(strip.writes - writes) / moves;
+
+    int refreshes = moves / 10 + 1;
+    uint64_t sim = g_sim_us;
+    start = Clock::now();
+    for (int r = 0; r < refreshes; r++) {
+        strip.refreshLEDs();
+    }
+    cost.refr_ns = elapsed_ns(start) / refreshes;
+    g_sim_us = sim;
+}
+
+template <int N>
+Cost run_old(int moves, uint32_t seconds) {
+    Cost cost{};
+    g_sim_us = 0;
+    OldGame<N> game;
+    uint64_t end_us = seconds * 1000000ULL;
+    while (g_sim_us < end_us) {
+        uint64_t before = g_sim_us;
+        game.loopPass();
+        sim_advance_us(c_pass_us);
+        // Everything but the delay(1) and the pass itself was the strip
+        cost.busy_ms += (g_sim_us - before - 1000 - c_pass_us) / 1000.0;
+    }
+    cost.refreshes = game.strip.refreshes;
+    cost.busy_ms /= seconds;
+
+    time_moves(game.strip, &game.numberOfInvaders, N, moves, [&] { game.moveInvaders(); }, cost);
+    return cost;
+}
+
+Cost run_new(const Sketch& sk, int moves, uint32_t seconds) {
+    Cost cost{};
+    g_sim_us = 0;
+    sk.setup();
+    uint32_t refreshes = sk.strip->refreshes;
+    uint64_t end_us = seconds * 1000000ULL;
+    while (g_sim_us < end_us) {
+        uint64_t before = g_sim_us;
+        uint32_t count = sk.strip->refreshes;
+        sk.loop();
+        if (sk.strip->refreshes != count) {
+            cost.busy_ms += (g_sim_us - before) / 1000.0;
+        }
+        sim_advance_us(c_pass_us);
+    }
+    cost.refreshes = sk.strip->refreshes - refreshes;
+    cost.busy_ms /= seconds;
+
+    time_moves(*sk.strip, sk.numberOfInvaders, sk.leds, moves, [&] { sk.moveInvaders(); }, cost);
+    return cost;
+}
+
+void print_row(int leds, const Cost& old_cost, const Cost& new_cost) {
+    std::printf("%5d", leds);
+    for (const Cost* c : {&old_cost, &new_cost}) {
+        std::printf(" | %9.1f %7.1f %9.1f %9u %7.1f", c->move_ns, c->writes, c->refr_ns, c->refreshes, c->busy_ms);
+    }
+    std::printf("\n");
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-m moves] [-t seconds]\n", prog);
+    std::exit(1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int moves = 200000;
+    uint32_t seconds = 10;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:t:")) != -1) {
+        switch (opt) {
+            case 'm': moves = std::atoi(optarg); break;
+            case 't': seconds = std::atoi(optarg); break;
+            default: usage(argv[0]);
+        }
+    }
+    if (moves <= 0 || seconds == 0) {
+        usage(argv[0]);
+    }
+
+    std::printf("%d moves per length, %u s of simulated play, %u us per LED to refresh\n", moves, seconds,
+                g_refresh_us_per_led);
+    std::printf("%5s | %-45s | %s\n", "", "shift and rewrite, HSV strip, refresh every pass",
+                "ring buffer, GRB strip, refresh when dirty");
+    std::printf("%5s", "leds");
+    for (int v = 0; v < 2; v++) {
+        std::printf(" | %9s %7s %9s %9s %7s", "move_ns", "writes", "refr_ns", "refreshes", "busy");
+    }
+    std::printf("\n");
+
+    print_row(30, run_old<30>(moves, seconds), run_new(SKETCH(30), moves, seconds));
+    print_row(60, run_old<60>(moves, seconds), run_new(SKETCH(60), moves, seconds));
+    print_row(120, run_old<120>(moves, seconds), run_new(SKETCH(120), moves, seconds));
+    print_row(150, run_old<150>(moves, seconds), run_new(SKETCH(150), moves, seconds));
+    print_row(255, run_old<255>(moves, seconds), run_new(SKETCH(255), moves, seconds));
+    return 0;
+}